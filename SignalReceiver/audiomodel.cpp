@@ -2,6 +2,8 @@
 
 AudioModel::AudioModel(QObject *parent)
     : QObject(parent)
+    , playback_device_(new WavStreamDevice(this))
+    , convert_device_(new PcmConvertDevice(this))
     , playback_timer_(new QTimer(this))
 {
     // 设置计时器
@@ -15,72 +17,75 @@ AudioModel::~AudioModel()
 
 bool AudioModel::LoadWavFile(const QString &file_path)
 {
-    QFile file(file_path);
-    if (!file.open(QIODevice::ReadOnly)) {
-        return false;
-    }
-    // WAV文件头解析
-    struct WavHeader {
-        char riff[4];
-        uint32_t file_size;
-        char wave[4];
-        char fmt[4];
-        uint32_t fmt_size;
-        uint16_t audio_format;
-        uint16_t num_channels;
-        uint32_t sample_rate;
-        uint32_t byte_rate;
-        uint16_t block_align;
-        uint16_t bits_per_sample;
-        char data[4];
-        uint32_t data_size;
-    };
-    WavHeader header;
-    // 读取WAV头部信息，检查返回读取的字节数是否正确
-    if (file.read(reinterpret_cast<char *>(&header), sizeof(WavHeader)) != sizeof(WavHeader)) {
-        return false;
-    }
-    // 验证WAV格式
-    if (strncmp(header.riff, "RIFF", 4) != 0 || strncmp(header.wave, "WAVE", 4) != 0) {
+    // 只解析块结构，音频数据在播放时由流式设备按窗口读取
+    StopPlayback();
+    wav_info_ = WavFile::Info();
+    playback_duration_ms_ = 0;
+    if (!WavFile::ReadInfo(file_path, wav_info_, &error_message_)) {
+        wav_info_ = WavFile::Info();
         return false;
     }
-    // 设置播放格式
-    playback_format_.setChannelCount(header.num_channels);
-    playback_format_.setSampleRate(header.sample_rate);
-    playback_format_.setSampleFormat(header.bits_per_sample == 16 ? QAudioFormat::Int16 : QAudioFormat::Float);
-    // 读取音频数据
-    playback_data_ = file.read(header.data_size);
-    // 计算总时长（秒）
-    const int bytes_per_second = header.sample_rate * header.num_channels * (header.bits_per_sample / 8);
-    playback_total_duration_ = playback_data_.size() / bytes_per_second;
-
-    return !playback_data_.isEmpty();
+    wav_file_path_ = file_path;
+    playback_duration_ms_ = wav_info_.FrameCount() * 1000 / wav_info_.sample_rate;
+    return true;
 }
 
 bool AudioModel::StartPlayback()
 {
-    if (playback_data_.isEmpty()) {
+    if (wav_info_.data_size <= 0) {
+        error_message_ = "未加载WAV文件";
         return false;
     }
-    // 获取默认音频输出设备
-    const auto output_device = QMediaDevices::defaultAudioOutput();
-    if (!output_device.isFormatSupported(playback_format_)) {
+    // 打开流式数据源，从上次定位的位置开始播放（默认为开头）
+    if (!playback_device_->Open(wav_file_path_, wav_info_.data_offset, wav_info_.data_size)) {
+        error_message_ = playback_device_->get_error_message();
         return false;
     }
+    // 获取默认音频输出设备，文件格式可直接播放时不经过转换
+    const auto output_device = QMediaDevices::defaultAudioOutput();
+    QAudioFormat source_format;
+    source_format.setChannelCount(wav_info_.channel_count);
+    source_format.setSampleRate(wav_info_.sample_rate);
+    source_format.setSampleFormat(PcmConvertDevice::SampleFormatFor(wav_info_.encoding));
+    QIODevice *device = playback_device_;
+    playback_format_ = source_format;
+    if (source_format.sampleFormat() == QAudioFormat::Unknown || !output_device.isFormatSupported(source_format)) {
+        playback_format_ = SelectOutputFormat(output_device);
+        if (!convert_device_->Open(playback_device_, wav_info_, playback_format_)) {
+            error_message_ = "输出设备不支持可转换的音频格式";
+            playback_device_->close();
+            return false;
+        }
+        device = convert_device_;
+    }
+    active_device_ = device;
+    if (start_position_ms_ > 0 && !SeekDevice(start_position_ms_)) {
+        start_position_ms_ = 0;
+    }
     // 创建音频输出
     audio_sink_ = new QAudioSink(output_device, playback_format_, this);
-    // 创建播放缓冲区
-    playback_buffer_ = new QBuffer(&playback_data_, this);
-    playback_buffer_->open(QIODevice::ReadOnly);
-    // 开始播放
-    audio_sink_->start(playback_buffer_);
-    // 启动进度定时器
-    playback_current_position_ = 0;
-    playback_timer_->start(1000); // 每秒更新一次进度
+    audio_sink_->start(device);
+    // 启动进度定时器，位置在每次触发时从输出设备读取
+    playback_timer_->start(kPositionUpdateInterval);
 
     return true;
 }
 
+QAudioFormat AudioModel::SelectOutputFormat(const QAudioDevice &output_device) const
+{
+    // 优先保持文件的采样率与声道数，只转换采样格式；都不支持时使用设备首选格式
+    QAudioFormat format;
+    format.setChannelCount(wav_info_.channel_count);
+    format.setSampleRate(wav_info_.sample_rate);
+    for (const auto sample_format : { QAudioFormat::Float, QAudioFormat::Int32, QAudioFormat::Int16 }) {
+        format.setSampleFormat(sample_format);
+        if (output_device.isFormatSupported(format)) {
+            return format;
+        }
+    }
+    return output_device.preferredFormat();
+}
+
 void AudioModel::StopPlayback()
 {
     playback_timer_->stop();
@@ -89,22 +94,89 @@ void AudioModel::StopPlayback()
         delete audio_sink_;
         audio_sink_ = nullptr;
     }
-    if (playback_buffer_) {
-        playback_buffer_->close();
-        delete playback_buffer_;
-        playback_buffer_ = nullptr;
-    }
-    playback_current_position_ = 0;
-    emit PlaybackPositionChanged(0, playback_total_duration_);
+    active_device_ = nullptr;
+    convert_device_->close();
+    playback_device_->close();
+    start_position_ms_ = 0;
+    emit PlaybackPositionChanged(0, playback_duration_ms_);
 }
 
 void AudioModel::PausePlayback()
 {
-    if (audio_sink_->state() == QAudio::ActiveState) {
+    if (!audio_sink_) {
+        return;
+    }
+    if (audio_sink_->state() == QAudio::SuspendedState) {
+        audio_sink_->resume();
+        playback_timer_->start(kPositionUpdateInterval);
+    } else {
         audio_sink_->suspend();
         playback_timer_->stop();
-    } else if (audio_sink_->state() == QAudio::SuspendedState) {
-        audio_sink_->resume();
-        playback_timer_->start(1000);
+        emit PlaybackPositionChanged(PlaybackPositionMs(), playback_duration_ms_);
+    }
+}
+
+bool AudioModel::SeekPlayback(qint64 position_ms)
+{
+    if (playback_duration_ms_ <= 0) {
+        return false;
+    }
+    position_ms = qBound<qint64>(0, position_ms, playback_duration_ms_);
+    if (!audio_sink_) {
+        start_position_ms_ = position_ms;
+        emit PlaybackPositionChanged(position_ms, playback_duration_ms_);
+        return true;
+    }
+    // 停止输出以丢弃缓冲中的旧数据，重定位数据源后从新位置重新拉取，无需重新加载文件
+    const bool suspended = audio_sink_->state() == QAudio::SuspendedState;
+    const qint64 current_ms = PlaybackPositionMs();
+    audio_sink_->stop();
+    const bool seeked = SeekDevice(position_ms);
+    if (!seeked) {
+        error_message_ = "无法定位到指定位置";
+        position_ms = current_ms;
+        SeekDevice(position_ms);
+    }
+    start_position_ms_ = position_ms;
+    audio_sink_->start(active_device_);
+    if (suspended) {
+        audio_sink_->suspend();
+    }
+    emit PlaybackPositionChanged(position_ms, playback_duration_ms_);
+    return seeked;
+}
+
+qint64 AudioModel::PlaybackPositionMs() const
+{
+    if (!audio_sink_) {
+        return start_position_ms_;
+    }
+    // processedUSecs 为写入输出缓冲的时长，扣除缓冲中尚未播放的部分即为实际播放位置
+    const qint64 buffered_bytes = qMax<qint64>(0, audio_sink_->bufferSize() - audio_sink_->bytesFree());
+    const qint64 played_us = audio_sink_->processedUSecs() - playback_format_.durationForBytes(buffered_bytes);
+    return qBound<qint64>(0, start_position_ms_ + qMax<qint64>(0, played_us) / 1000, playback_duration_ms_);
+}
+
+bool AudioModel::SeekDevice(qint64 position_ms)
+{
+    if (!active_device_) {
+        return false;
+    }
+    // 按输出格式换算字节位置，转换设备再将其映射到源帧
+    const qint64 frame = position_ms * playback_format_.sampleRate() / 1000;
+    return active_device_->seek(frame * playback_format_.bytesPerFrame());
+}
+
+void AudioModel::SlotPlaybackUpdate()
+{
+    if (!audio_sink_) {
+        return;
+    }
+    // 数据源已读完且输出缓冲播放完毕时，输出设备进入空闲状态
+    if (audio_sink_->state() == QAudio::IdleState && active_device_ && active_device_->atEnd()) {
+        StopPlayback();
+        emit PlaybackFinished();
+        return;
     }
+    emit PlaybackPositionChanged(PlaybackPositionMs(), playback_duration_ms_);
 }
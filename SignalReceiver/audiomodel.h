@@ -7,7 +7,9 @@
 #include <QTimer>
 #include <QFile>
 #include <QAudioSink>
-#include <QBuffer>
+#include "wavstreamdevice.h"
+#include "pcmconvertdevice.h"
+#include "wavfile.h"
 
 class AudioModel  : public QObject
 {
@@ -22,35 +24,43 @@ public:
     bool StartPlayback();
     void StopPlayback();
     void PausePlayback();
+    // 定位到指定毫秒：播放或暂停中直接重定位数据源，未播放时作为下次播放的起点
+    bool SeekPlayback(qint64 position_ms);
     bool IsPlaying() const { return audio_sink_ && audio_sink_->state() == QAudio::ActiveState; }
+    // 当前播放位置（毫秒），由输出设备已处理的时长扣除尚在缓冲区中的部分得出
+    qint64 PlaybackPositionMs() const;
     // 获取私有变量值
-    int get_playback_total_duration() const { return playback_total_duration_; }
+    qint64 get_playback_duration_ms() const { return playback_duration_ms_; }
+    const WavFile::Info &get_wav_info() const { return wav_info_; }
+    QString get_error_message() const { return error_message_; }
+
+private:
+    QAudioFormat SelectOutputFormat(const QAudioDevice &output_device) const;
+    bool SeekDevice(qint64 position_ms);
 
 private:
     // 播放相关
     QAudioSink *audio_sink_{ nullptr };
-    QBuffer *playback_buffer_{ nullptr };
-    QByteArray playback_data_;
-    QAudioFormat playback_format_;
-    QTimer *playback_timer_;
-    int playback_total_duration_{ 0 };
-    int playback_current_position_{ 0 };
+    WavStreamDevice *playback_device_;  // 按窗口流式读取音频数据，播放可立即开始
+    PcmConvertDevice *convert_device_;  // 输出设备不支持文件格式时的转换层
+    QIODevice *active_device_{ nullptr }; // 实际送入 QAudioSink 的设备，二者之一
+    QString wav_file_path_;
+    WavFile::Info wav_info_;
+    QAudioFormat playback_format_;      // 实际送入 QAudioSink 的格式
+    QString error_message_;
+    QTimer *playback_timer_;            // 只负责按周期上报位置，位置本身取自输出设备
+    qint64 playback_duration_ms_{ 0 };
+    qint64 start_position_ms_{ 0 };     // 本次 start() 时数据源所在位置，processedUSecs 从此处起算
+
+    static constexpr int kPositionUpdateInterval{ 50 };
 
 private slots:
     // 播放进度更新
-    void SlotPlaybackUpdate() {
-        playback_current_position_++;
-        emit PlaybackPositionChanged(playback_current_position_, playback_total_duration_);
-        // 检查是否播放完成
-        if (playback_current_position_ >= playback_total_duration_) {
-            StopPlayback();
-            emit PlaybackFinished();
-        }
-    }
+    void SlotPlaybackUpdate();
 
 signals:
-    // 播放进度更新信号
-    void PlaybackPositionChanged(int current_seconds, int total_seconds);
+    // 播放进度更新信号（毫秒）
+    void PlaybackPositionChanged(qint64 position_ms, qint64 duration_ms);
     // 播放完成信号
     void PlaybackFinished();
 };
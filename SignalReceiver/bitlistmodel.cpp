@@ -0,0 +1,78 @@
+﻿#include "bitlistmodel.h"
+#include <limits>
+
+BitListModel::BitListModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , bits_(&appended_bits_)
+{}
+
+void BitListModel::set_bits(const BitStream *bits)
+{
+    beginResetModel();
+    appended_bits_.Clear();
+    bits_ = bits ? bits : &appended_bits_;
+    endResetModel();
+}
+
+void BitListModel::Append(const BitStream &bits)
+{
+    if (bits.isEmpty()) {
+        return;
+    }
+    // 之前引用的是外部比特流时先切换回自有比特流
+    if (bits_ != &appended_bits_) {
+        set_bits(nullptr);
+    }
+    const int old_rows = RowsFor(appended_bits_.size());
+    const int new_rows = RowsFor(appended_bits_.size() + bits.size());
+    const bool last_row_partial = appended_bits_.size() % kBitsPerRow != 0;
+    if (new_rows > old_rows) {
+        beginInsertRows(QModelIndex(), old_rows, new_rows - 1);
+    }
+    for (qsizetype i{ 0 }; i < bits.size(); ++i) {
+        appended_bits_.AppendBit(bits.Bit(i));
+    }
+    if (new_rows > old_rows) {
+        endInsertRows();
+    }
+    // 原末行未满时其内容也有变化
+    if (last_row_partial) {
+        const auto last = index(old_rows - 1);
+        emit dataChanged(last, last, { Qt::DisplayRole });
+    }
+}
+
+void BitListModel::Clear()
+{
+    set_bits(nullptr);
+}
+
+int BitListModel::RowsFor(qsizetype bit_count)
+{
+    const auto rows = (bit_count + kBitsPerRow - 1) / kBitsPerRow;
+    return static_cast<int>(qMin<qsizetype>(rows, std::numeric_limits<int>::max()));
+}
+
+int BitListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : RowsFor(bits_->size());
+}
+
+QVariant BitListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    const qsizetype first = static_cast<qsizetype>(index.row()) * kBitsPerRow;
+    const qsizetype last = qMin<qsizetype>(first + kBitsPerRow, bits_->size());
+    // 行首为首个比特的序号，之后每 8 位一组
+    QString text = QString("%1 ").arg(first, 10);
+    text.reserve(text.size() + kBitsPerRow + kBitsPerRow / 8);
+    for (auto i{ first }; i < last; ++i) {
+        if ((i - first) % 8 == 0) {
+            text += QChar(' ');
+        }
+        text += bits_->Bit(i) ? QChar('1') : QChar('0');
+    }
+    return text;
+}
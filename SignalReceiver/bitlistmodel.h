@@ -0,0 +1,33 @@
+﻿#pragma once
+
+#include <QAbstractListModel>
+#include "bitstream.h"
+
+// 比特视图模型：每行 64 比特，按 8 位一组显示，只格式化可见行。
+// 文件解调结果直接引用 TxtModel 的比特流；流式解调的结果追加到模型自有的比特流中，
+// 只插入新增的行并刷新未满的末行
+class BitListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    BitListModel(QObject *parent);
+
+    // bits 由调用方持有，需在下次 set_bits/Clear 前保持有效且不被修改
+    void set_bits(const BitStream *bits);
+    void Append(const BitStream &bits);
+    void Clear();
+    qsizetype get_bit_count() const { return bits_->size(); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    static constexpr int kBitsPerRow{ 64 };
+
+private:
+    static int RowsFor(qsizetype bit_count);
+
+private:
+    const BitStream *bits_;
+    BitStream appended_bits_;
+};
@@ -0,0 +1,59 @@
+﻿#include "bitstream.h"
+
+BitStream::BitStream()
+{}
+
+void BitStream::Clear()
+{
+    words_.clear();
+    size_ = 0;
+}
+
+void BitStream::Reserve(qsizetype bit_count)
+{
+    words_.reserve(WordsFor(bit_count));
+}
+
+void BitStream::Resize(qsizetype bit_count)
+{
+    // 缩短时清除被截掉的比特，保证再次增长后为 0
+    if (bit_count < size_) {
+        words_.resize(WordsFor(bit_count));
+        if (bit_count % 64) {
+            const auto keep = static_cast<int>(bit_count % 64);
+            auto *last_bytes = bytes() + (bit_count / 64) * 8;
+            for (auto i{ keep / 8 }; i < 8; ++i) {
+                last_bytes[i] &= (i == keep / 8) ? static_cast<uint8_t>(0xFF00 >> (keep % 8)) : 0;
+            }
+        }
+    } else {
+        words_.resize(WordsFor(bit_count), 0);
+    }
+    size_ = bit_count;
+}
+
+void BitStream::AppendBit(bool bit)
+{
+    if (size_ % 64 == 0) {
+        words_.append(0);
+    }
+    if (bit) {
+        bytes()[size_ >> 3] |= static_cast<uint8_t>(0x80 >> (size_ & 7));
+    }
+    ++size_;
+}
+
+void BitStream::SetBit(qsizetype index, bool bit)
+{
+    const auto mask = static_cast<uint8_t>(0x80 >> (index & 7));
+    if (bit) {
+        bytes()[index >> 3] |= mask;
+    } else {
+        bytes()[index >> 3] &= static_cast<uint8_t>(~mask);
+    }
+}
+
+QByteArrayView BitStream::CompleteBytes() const
+{
+    return QByteArrayView(constBytes(), ByteCount());
+}
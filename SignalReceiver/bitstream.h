@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <QList>
+#include <QByteArrayView>
+#include <cstdint>
+
+// 紧凑比特流：以 64 位字为单位分配，每比特只占 1 位。
+// 第 i 个比特位于底层内存第 i/8 个字节的第 (7 - i%8) 位（高位在前），
+// 与主机字节序无关，因此完整字节部分可以直接当作解码后的字节序列使用
+class BitStream
+{
+public:
+    BitStream();
+
+    void Clear();
+    void Reserve(qsizetype bit_count);
+    // 调整长度，新增比特为 0
+    void Resize(qsizetype bit_count);
+    void AppendBit(bool bit);
+    void SetBit(qsizetype index, bool bit);
+
+    bool Bit(qsizetype index) const { return (constBytes()[index >> 3] >> (7 - (index & 7))) & 1; }
+    qsizetype size() const { return size_; }
+    bool isEmpty() const { return size_ == 0; }
+
+    // 完整字节数（末尾不足 8 位的部分不计入）
+    qsizetype ByteCount() const { return size_ / 8; }
+    uint8_t Byte(qsizetype index) const { return constBytes()[index]; }
+    // 按字节访问底层存储，供解调内核直接写入、解码器直接读取
+    uint8_t *bytes() { return reinterpret_cast<uint8_t *>(words_.data()); }
+    const uint8_t *constBytes() const { return reinterpret_cast<const uint8_t *>(words_.constData()); }
+    // 完整字节部分的只读视图，不复制
+    QByteArrayView CompleteBytes() const;
+
+private:
+    static qsizetype WordsFor(qsizetype bit_count) { return (bit_count + 63) / 64; }
+
+private:
+    QList<quint64> words_;
+    qsizetype size_{ 0 };
+};
@@ -0,0 +1,112 @@
+﻿#include "checksum.h"
+#include <QtEndian>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SR_TARGET_SSE42
+#else
+#define SR_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+
+namespace Checksum {
+
+namespace {
+
+constexpr quint32 kCrc32cPolynomial{ 0x82F63B78 };  // 反射形式
+
+// 切片查表：table[k][b] 为字节 b 之后再经过 k 个零字节的 CRC
+using SliceTable = std::array<std::array<quint32, 256>, 8>;
+
+const SliceTable &Tables()
+{
+    static const SliceTable tables = [] {
+        SliceTable t{};
+        for (quint32 b{ 0 }; b < 256; ++b) {
+            quint32 crc = b;
+            for (int k{ 0 }; k < 8; ++k) {
+                crc = (crc >> 1) ^ ((crc & 1) ? kCrc32cPolynomial : 0);
+            }
+            t[0][b] = crc;
+        }
+        for (quint32 b{ 0 }; b < 256; ++b) {
+            for (int k{ 1 }; k < 8; ++k) {
+                t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xFF];
+            }
+        }
+        return t;
+    }();
+    return tables;
+}
+
+quint32 Crc32cSoftware(const char *data, qint64 size, quint32 crc)
+{
+    const auto &t = Tables();
+    const auto *p = reinterpret_cast<const unsigned char *>(data);
+    crc = ~crc;
+    while (size >= 8) {
+        const auto low = qFromLittleEndian<quint32>(p) ^ crc;
+        const auto high = qFromLittleEndian<quint32>(p + 4);
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+            ^ t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return ~crc;
+}
+
+SR_TARGET_SSE42 quint32 Crc32cHardware(const char *data, qint64 size, quint32 crc)
+{
+    const auto *p = reinterpret_cast<const unsigned char *>(data);
+    quint64 crc64 = ~crc;
+    while (size >= 8) {
+        quint64 value;
+        memcpy(&value, p, 8);
+        crc64 = _mm_crc32_u64(crc64, value);
+        p += 8;
+        size -= 8;
+    }
+    auto crc32 = static_cast<quint32>(crc64);
+    while (size-- > 0) {
+        crc32 = _mm_crc32_u8(crc32, *p++);
+    }
+    return ~crc32;
+}
+
+bool CpuSupportsSse42()
+{
+#if defined(_MSC_VER)
+    int info[4]{};
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#endif
+}
+
+using Crc32cFn = quint32 (*)(const char *, qint64, quint32);
+
+std::atomic<Crc32cFn> active_crc32c{ nullptr };
+
+}
+
+quint32 Crc32c(const char *data, qint64 size, quint32 crc)
+{
+    auto fn = active_crc32c.load(std::memory_order_acquire);
+    if (!fn) {
+        fn = CpuSupportsSse42() ? Crc32cHardware : Crc32cSoftware;
+        active_crc32c.store(fn, std::memory_order_release);
+    }
+    return fn(data, size, crc);
+}
+
+}
@@ -0,0 +1,12 @@
+﻿#pragma once
+
+#include <QtGlobal>
+
+// 校验和：CRC32C（Castagnoli），支持 SSE4.2 的 CPU 上使用硬件 crc32 指令，
+// 否则回退到按 8 字节切片的查表实现
+namespace Checksum {
+
+// 可分段增量计算：crc 传入上一段的返回值，首段传 0
+quint32 Crc32c(const char *data, qint64 size, quint32 crc = 0);
+
+}
@@ -0,0 +1,116 @@
+﻿#include "demodengine.h"
+#include "demodkernels.h"
+#include "metrics.h"
+#include <QThread>
+
+DemodEngine::DemodEngine(QObject *parent)
+    : QObject(parent)
+{
+    pool_.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+DemodEngine::~DemodEngine()
+{
+    Cancel();
+    WaitForFinished();
+}
+
+bool DemodEngine::Start(Scheme scheme, const double *samples, qsizetype bit_count, qsizetype samples_per_bit,
+                        double threshold, const double *reference, uint8_t *packed)
+{
+    if (running_) {
+        return false;
+    }
+    synchronous_ = false;
+    Submit(scheme, samples, bit_count, samples_per_bit, threshold, reference, packed);
+    if (bit_count == 0) {
+        // 没有完整比特，仍通过事件循环通知完成，保持与异步流程一致
+        QMetaObject::invokeMethod(this, &DemodEngine::Finish, Qt::QueuedConnection);
+    }
+    return true;
+}
+
+bool DemodEngine::Run(Scheme scheme, const double *samples, qsizetype bit_count, qsizetype samples_per_bit,
+                      double threshold, const double *reference, uint8_t *packed)
+{
+    if (running_) {
+        return false;
+    }
+    synchronous_ = true;
+    Submit(scheme, samples, bit_count, samples_per_bit, threshold, reference, packed);
+    pool_.waitForDone();
+    running_ = false;
+    return !cancel_requested_.load();
+}
+
+void DemodEngine::Submit(Scheme scheme, const double *samples, qsizetype bit_count, qsizetype samples_per_bit,
+                         double threshold, const double *reference, uint8_t *packed)
+{
+    scheme_ = scheme;
+    samples_ = samples;
+    total_bits_ = bit_count;
+    samples_per_bit_ = samples_per_bit;
+    threshold_ = threshold;
+    reference_ = reference;
+    packed_ = packed;
+    cancel_requested_ = false;
+    bits_done_ = 0;
+    last_percent_ = -1;
+    running_ = true;
+    // 按比特边界切块并全部提交到线程池
+    const auto chunk_count = (bit_count + kBitsPerChunk - 1) / kBitsPerChunk;
+    chunks_remaining_ = chunk_count;
+    for (qsizetype chunk{ 0 }; chunk < chunk_count; ++chunk) {
+        const auto first_bit = chunk * kBitsPerChunk;
+        const auto chunk_bits = qMin(kBitsPerChunk, bit_count - first_bit);
+        pool_.start([this, first_bit, chunk_bits] { RunChunk(first_bit, chunk_bits); });
+    }
+}
+
+void DemodEngine::Cancel()
+{
+    cancel_requested_ = true;
+}
+
+void DemodEngine::WaitForFinished()
+{
+    pool_.waitForDone();
+}
+
+void DemodEngine::RunChunk(qsizetype first_bit, qsizetype bit_count)
+{
+    // 已请求取消的块直接跳过
+    if (!cancel_requested_.load(std::memory_order_relaxed)) {
+        Metrics::ScopedTimer timer(Metrics::kDemodulate, bit_count * samples_per_bit_ * sizeof(double), bit_count);
+        const auto *samples = samples_ + first_bit * samples_per_bit_;
+        if (scheme_ == kAsk) {
+            DemodKernels::DemodulateAsk(samples, bit_count, samples_per_bit_, threshold_, packed_ + first_bit / 8);
+        } else {
+            DemodKernels::DemodulatePsk(samples, bit_count, samples_per_bit_, reference_, packed_ + first_bit / 8);
+        }
+    }
+    OnChunkDone(bit_count);
+}
+
+void DemodEngine::OnChunkDone(qsizetype bit_count)
+{
+    const auto done = bits_done_.fetch_add(bit_count) + bit_count;
+    // 进度只在百分比变化时跨线程通知，避免大量排队信号
+    const int percent = static_cast<int>(done * 100 / total_bits_);
+    int last = last_percent_.load();
+    while (percent > last) {
+        if (last_percent_.compare_exchange_weak(last, percent)) {
+            emit progressChanged(percent);
+            break;
+        }
+    }
+    if (chunks_remaining_.fetch_sub(1) == 1 && !synchronous_) {
+        QMetaObject::invokeMethod(this, &DemodEngine::Finish, Qt::QueuedConnection);
+    }
+}
+
+void DemodEngine::Finish()
+{
+    running_ = false;
+    emit finished(cancel_requested_.load());
+}
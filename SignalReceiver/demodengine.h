@@ -0,0 +1,63 @@
+﻿#pragma once
+
+#include <QObject>
+#include <QThreadPool>
+#include <atomic>
+#include <cstdint>
+
+// 并行解调引擎：已知比特边界后各比特相互独立，按比特对齐切块后
+// 分发到线程池，各块直接写入预先分配好的打包比特缓冲
+class DemodEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Scheme {
+        kAsk,
+        kPsk
+    };
+
+    DemodEngine(QObject *parent);
+    ~DemodEngine();
+
+    // samples 与 packed 在完成前必须保持有效；packed 按高位在前打包，需容纳 bit_count 个比特
+    bool Start(Scheme scheme, const double *samples, qsizetype bit_count, qsizetype samples_per_bit,
+               double threshold, const double *reference, uint8_t *packed);
+    // 同步版本：同样并行执行，但阻塞到全部完成，不发出 finished 信号
+    bool Run(Scheme scheme, const double *samples, qsizetype bit_count, qsizetype samples_per_bit,
+             double threshold, const double *reference, uint8_t *packed);
+    void Cancel();
+    void WaitForFinished();
+    bool IsRunning() const { return running_; }
+
+    // 每块的比特数，取 64 的倍数，保证各块写入互不重叠的 64 位字
+    static constexpr qsizetype kBitsPerChunk{ 64 * 1024 };
+
+signals:
+    void progressChanged(int percent);
+    void finished(bool canceled);
+
+private:
+    void Submit(Scheme scheme, const double *samples, qsizetype bit_count, qsizetype samples_per_bit,
+                double threshold, const double *reference, uint8_t *packed);
+    void RunChunk(qsizetype first_bit, qsizetype bit_count);
+    void OnChunkDone(qsizetype bit_count);
+    void Finish();
+
+private:
+    QThreadPool pool_;
+    bool running_{ false };
+    bool synchronous_{ false };
+    Scheme scheme_{ kAsk };
+    const double *samples_{ nullptr };
+    qsizetype total_bits_{ 0 };
+    qsizetype samples_per_bit_{ 0 };
+    double threshold_{ 0.0 };
+    const double *reference_{ nullptr };
+    uint8_t *packed_{ nullptr };
+
+    std::atomic<bool> cancel_requested_{ false };
+    std::atomic<qsizetype> bits_done_{ 0 };
+    std::atomic<qsizetype> chunks_remaining_{ 0 };
+    std::atomic<int> last_percent_{ -1 };
+};
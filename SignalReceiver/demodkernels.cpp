@@ -0,0 +1,480 @@
+﻿#include "demodkernels.h"
+#include <atomic>
+#include <utility>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// MSVC 可直接使用任意内建指令；GCC/Clang 需为函数单独开启目标指令集
+#if defined(_MSC_VER) && !defined(__clang__)
+#define SR_TARGET_AVX2
+#else
+#define SR_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+namespace DemodKernels {
+
+namespace {
+
+// 标量参考实现
+double EnergyScalar(const double *x, qsizetype n)
+{
+    double energy{ 0.0 };
+    for (qsizetype i{ 0 }; i < n; ++i) {
+        energy += x[i] * x[i];
+    }
+    return energy;
+}
+
+double CorrelationScalar(const double *x, const double *ref, qsizetype n)
+{
+    double correlation{ 0.0 };
+    for (qsizetype i{ 0 }; i < n; ++i) {
+        correlation += x[i] * ref[i];
+    }
+    return correlation;
+}
+
+// SSE2：x64 下必然可用，每次处理 2 个 double
+double EnergySse2(const double *x, qsizetype n)
+{
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    qsizetype i{ 0 };
+    for (; i + 4 <= n; i += 4) {
+        const __m128d a = _mm_loadu_pd(x + i);
+        const __m128d b = _mm_loadu_pd(x + i + 2);
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(a, a));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(b, b));
+    }
+    acc0 = _mm_add_pd(acc0, acc1);
+    double energy = _mm_cvtsd_f64(_mm_add_sd(acc0, _mm_unpackhi_pd(acc0, acc0)));
+    for (; i < n; ++i) {
+        energy += x[i] * x[i];
+    }
+    return energy;
+}
+
+double CorrelationSse2(const double *x, const double *ref, qsizetype n)
+{
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    qsizetype i{ 0 };
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(ref + i)));
+        acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(ref + i + 2)));
+    }
+    acc0 = _mm_add_pd(acc0, acc1);
+    double correlation = _mm_cvtsd_f64(_mm_add_sd(acc0, _mm_unpackhi_pd(acc0, acc0)));
+    for (; i < n; ++i) {
+        correlation += x[i] * ref[i];
+    }
+    return correlation;
+}
+
+// AVX2 + FMA：每次处理 4 个 double，两路累加隐藏 FMA 延迟
+SR_TARGET_AVX2 double HorizontalSum(__m256d v)
+{
+    const __m128d low = _mm256_castpd256_pd128(v);
+    const __m128d high = _mm256_extractf128_pd(v, 1);
+    const __m128d sum = _mm_add_pd(low, high);
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+SR_TARGET_AVX2 double EnergyAvx2(const double *x, qsizetype n)
+{
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    qsizetype i{ 0 };
+    for (; i + 8 <= n; i += 8) {
+        const __m256d a = _mm256_loadu_pd(x + i);
+        const __m256d b = _mm256_loadu_pd(x + i + 4);
+        acc0 = _mm256_fmadd_pd(a, a, acc0);
+        acc1 = _mm256_fmadd_pd(b, b, acc1);
+    }
+    if (i + 4 <= n) {
+        const __m256d a = _mm256_loadu_pd(x + i);
+        acc0 = _mm256_fmadd_pd(a, a, acc0);
+        i += 4;
+    }
+    double energy = HorizontalSum(_mm256_add_pd(acc0, acc1));
+    for (; i < n; ++i) {
+        energy += x[i] * x[i];
+    }
+    return energy;
+}
+
+SR_TARGET_AVX2 double CorrelationAvx2(const double *x, const double *ref, qsizetype n)
+{
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    qsizetype i{ 0 };
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(ref + i), acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(ref + i + 4), acc1);
+    }
+    if (i + 4 <= n) {
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(ref + i), acc0);
+        i += 4;
+    }
+    double correlation = HorizontalSum(_mm256_add_pd(acc0, acc1));
+    for (; i < n; ++i) {
+        correlation += x[i] * ref[i];
+    }
+    return correlation;
+}
+
+// 批量解调：内层内核内联进比特循环，避免每比特一次间接调用；
+// 每 8 个判决结果在寄存器中拼成一个字节后再写出
+template <double (*EnergyFn)(const double *, qsizetype)>
+void DemodulateAskImpl(const double *x, qsizetype bit_count, qsizetype spb, double threshold, uint8_t *packed)
+{
+    for (qsizetype i{ 0 }; i < bit_count; i += 8) {
+        const auto n = qMin<qsizetype>(8, bit_count - i);
+        unsigned byte{ 0 };
+        for (qsizetype j{ 0 }; j < n; ++j) {
+            byte |= (EnergyFn(x + (i + j) * spb, spb) > threshold ? 1u : 0u) << (7 - j);
+        }
+        packed[i / 8] = static_cast<uint8_t>(byte);
+    }
+}
+
+template <double (*CorrelationFn)(const double *, const double *, qsizetype)>
+void DemodulatePskImpl(const double *x, qsizetype bit_count, qsizetype spb, const double *ref, uint8_t *packed)
+{
+    for (qsizetype i{ 0 }; i < bit_count; i += 8) {
+        const auto n = qMin<qsizetype>(8, bit_count - i);
+        unsigned byte{ 0 };
+        for (qsizetype j{ 0 }; j < n; ++j) {
+            byte |= (CorrelationFn(x + (i + j) * spb, ref, spb) < 0 ? 1u : 0u) << (7 - j);
+        }
+        packed[i / 8] = static_cast<uint8_t>(byte);
+    }
+}
+
+SR_TARGET_AVX2 void DemodulateAskAvx2(const double *x, qsizetype bit_count, qsizetype spb, double threshold, uint8_t *packed)
+{
+    for (qsizetype i{ 0 }; i < bit_count; i += 8) {
+        const auto n = qMin<qsizetype>(8, bit_count - i);
+        unsigned byte{ 0 };
+        for (qsizetype j{ 0 }; j < n; ++j) {
+            byte |= (EnergyAvx2(x + (i + j) * spb, spb) > threshold ? 1u : 0u) << (7 - j);
+        }
+        packed[i / 8] = static_cast<uint8_t>(byte);
+    }
+}
+
+SR_TARGET_AVX2 void DemodulatePskAvx2(const double *x, qsizetype bit_count, qsizetype spb, const double *ref, uint8_t *packed)
+{
+    for (qsizetype i{ 0 }; i < bit_count; i += 8) {
+        const auto n = qMin<qsizetype>(8, bit_count - i);
+        unsigned byte{ 0 };
+        for (qsizetype j{ 0 }; j < n; ++j) {
+            byte |= (CorrelationAvx2(x + (i + j) * spb, ref, spb) < 0 ? 1u : 0u) << (7 - j);
+        }
+        packed[i / 8] = static_cast<uint8_t>(byte);
+    }
+}
+
+// 每比特采样数为编译期常量的专用内核：用参数包展开代替循环，内层完全展开，
+// 没有循环计数与尾部处理；多路累加器打断加法的依赖链
+template <qsizetype... I>
+double EnergyScalarUnrolled(const double *x, std::integer_sequence<qsizetype, I...>)
+{
+    double acc[4]{};
+    ((acc[I % 4] += x[I] * x[I]), ...);
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+template <qsizetype... I>
+double CorrelationScalarUnrolled(const double *x, const double *ref, std::integer_sequence<qsizetype, I...>)
+{
+    double acc[4]{};
+    ((acc[I % 4] += x[I] * ref[I]), ...);
+    return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+}
+
+template <qsizetype... I>
+double EnergySse2Unrolled(const double *x, std::integer_sequence<qsizetype, I...>)
+{
+    __m128d acc[2]{ _mm_setzero_pd(), _mm_setzero_pd() };
+    ((acc[I & 1] = _mm_add_pd(acc[I & 1], _mm_mul_pd(_mm_loadu_pd(x + 2 * I), _mm_loadu_pd(x + 2 * I)))), ...);
+    const __m128d sum = _mm_add_pd(acc[0], acc[1]);
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+template <qsizetype... I>
+double CorrelationSse2Unrolled(const double *x, const double *ref, std::integer_sequence<qsizetype, I...>)
+{
+    __m128d acc[2]{ _mm_setzero_pd(), _mm_setzero_pd() };
+    ((acc[I & 1] = _mm_add_pd(acc[I & 1], _mm_mul_pd(_mm_loadu_pd(x + 2 * I), _mm_loadu_pd(ref + 2 * I)))), ...);
+    const __m128d sum = _mm_add_pd(acc[0], acc[1]);
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+template <qsizetype... I>
+SR_TARGET_AVX2 double EnergyAvx2Unrolled(const double *x, std::integer_sequence<qsizetype, I...>)
+{
+    __m256d acc[2]{ _mm256_setzero_pd(), _mm256_setzero_pd() };
+    ((acc[I & 1] = _mm256_fmadd_pd(_mm256_loadu_pd(x + 4 * I), _mm256_loadu_pd(x + 4 * I), acc[I & 1])), ...);
+    return HorizontalSum(_mm256_add_pd(acc[0], acc[1]));
+}
+
+template <qsizetype... I>
+SR_TARGET_AVX2 double CorrelationAvx2Unrolled(const double *x, const double *ref, std::integer_sequence<qsizetype, I...>)
+{
+    __m256d acc[2]{ _mm256_setzero_pd(), _mm256_setzero_pd() };
+    ((acc[I & 1] = _mm256_fmadd_pd(_mm256_loadu_pd(x + 4 * I), _mm256_loadu_pd(ref + 4 * I), acc[I & 1])), ...);
+    return HorizontalSum(_mm256_add_pd(acc[0], acc[1]));
+}
+
+template <qsizetype kSpb>
+double EnergyScalarFixed(const double *x)
+{
+    return EnergyScalarUnrolled(x, std::make_integer_sequence<qsizetype, kSpb>());
+}
+
+template <qsizetype kSpb>
+double CorrelationScalarFixed(const double *x, const double *ref)
+{
+    return CorrelationScalarUnrolled(x, ref, std::make_integer_sequence<qsizetype, kSpb>());
+}
+
+template <qsizetype kSpb>
+double EnergySse2Fixed(const double *x)
+{
+    return EnergySse2Unrolled(x, std::make_integer_sequence<qsizetype, kSpb / 2>());
+}
+
+template <qsizetype kSpb>
+double CorrelationSse2Fixed(const double *x, const double *ref)
+{
+    return CorrelationSse2Unrolled(x, ref, std::make_integer_sequence<qsizetype, kSpb / 2>());
+}
+
+template <qsizetype kSpb, double (*EnergyFn)(const double *)>
+void DemodulateAskFixed(const double *x, qsizetype bit_count, double threshold, uint8_t *packed)
+{
+    for (qsizetype i{ 0 }; i < bit_count; i += 8) {
+        const auto n = qMin<qsizetype>(8, bit_count - i);
+        unsigned byte{ 0 };
+        for (qsizetype j{ 0 }; j < n; ++j) {
+            byte |= (EnergyFn(x + (i + j) * kSpb) > threshold ? 1u : 0u) << (7 - j);
+        }
+        packed[i / 8] = static_cast<uint8_t>(byte);
+    }
+}
+
+template <qsizetype kSpb, double (*CorrelationFn)(const double *, const double *)>
+void DemodulatePskFixed(const double *x, qsizetype bit_count, const double *ref, uint8_t *packed)
+{
+    for (qsizetype i{ 0 }; i < bit_count; i += 8) {
+        const auto n = qMin<qsizetype>(8, bit_count - i);
+        unsigned byte{ 0 };
+        for (qsizetype j{ 0 }; j < n; ++j) {
+            byte |= (CorrelationFn(x + (i + j) * kSpb, ref) < 0 ? 1u : 0u) << (7 - j);
+        }
+        packed[i / 8] = static_cast<uint8_t>(byte);
+    }
+}
+
+// AVX2 版本的比特循环同样需带目标指令集属性，专用内核才能内联进来
+template <qsizetype kSpb>
+SR_TARGET_AVX2 void DemodulateAskAvx2Fixed(const double *x, qsizetype bit_count, double threshold, uint8_t *packed)
+{
+    for (qsizetype i{ 0 }; i < bit_count; i += 8) {
+        const auto n = qMin<qsizetype>(8, bit_count - i);
+        unsigned byte{ 0 };
+        for (qsizetype j{ 0 }; j < n; ++j) {
+            const double energy = EnergyAvx2Unrolled(x + (i + j) * kSpb, std::make_integer_sequence<qsizetype, kSpb / 4>());
+            byte |= (energy > threshold ? 1u : 0u) << (7 - j);
+        }
+        packed[i / 8] = static_cast<uint8_t>(byte);
+    }
+}
+
+template <qsizetype kSpb>
+SR_TARGET_AVX2 void DemodulatePskAvx2Fixed(const double *x, qsizetype bit_count, const double *ref, uint8_t *packed)
+{
+    for (qsizetype i{ 0 }; i < bit_count; i += 8) {
+        const auto n = qMin<qsizetype>(8, bit_count - i);
+        unsigned byte{ 0 };
+        for (qsizetype j{ 0 }; j < n; ++j) {
+            const double correlation = CorrelationAvx2Unrolled(x + (i + j) * kSpb, ref, std::make_integer_sequence<qsizetype, kSpb / 4>());
+            byte |= (correlation < 0 ? 1u : 0u) << (7 - j);
+        }
+        packed[i / 8] = static_cast<uint8_t>(byte);
+    }
+}
+
+using AskFixedFn = void (*)(const double *, qsizetype, double, uint8_t *);
+using PskFixedFn = void (*)(const double *, qsizetype, const double *, uint8_t *);
+
+// 专用内核对应的每比特采样数，下标与 KernelTable 中的专用内核数组一致
+constexpr qsizetype kFixedSamplesPerBit[]{ 8, 16, 32 };
+constexpr int kFixedCount{ 3 };
+
+int FixedIndex(qsizetype samples_per_bit)
+{
+    for (int i{ 0 }; i < kFixedCount; ++i) {
+        if (kFixedSamplesPerBit[i] == samples_per_bit) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+struct KernelTable {
+    Isa isa;
+    double (*energy)(const double *, qsizetype);
+    double (*correlation)(const double *, const double *, qsizetype);
+    void (*demodulate_ask)(const double *, qsizetype, qsizetype, double, uint8_t *);
+    void (*demodulate_psk)(const double *, qsizetype, qsizetype, const double *, uint8_t *);
+    AskFixedFn demodulate_ask_fixed[kFixedCount];
+    PskFixedFn demodulate_psk_fixed[kFixedCount];
+};
+
+constexpr KernelTable kScalarTable{ Isa::kScalar, EnergyScalar, CorrelationScalar,
+                                    DemodulateAskImpl<EnergyScalar>, DemodulatePskImpl<CorrelationScalar>,
+                                    { DemodulateAskFixed<8, EnergyScalarFixed<8>>,
+                                      DemodulateAskFixed<16, EnergyScalarFixed<16>>,
+                                      DemodulateAskFixed<32, EnergyScalarFixed<32>> },
+                                    { DemodulatePskFixed<8, CorrelationScalarFixed<8>>,
+                                      DemodulatePskFixed<16, CorrelationScalarFixed<16>>,
+                                      DemodulatePskFixed<32, CorrelationScalarFixed<32>> } };
+constexpr KernelTable kSse2Table{ Isa::kSse2, EnergySse2, CorrelationSse2,
+                                  DemodulateAskImpl<EnergySse2>, DemodulatePskImpl<CorrelationSse2>,
+                                  { DemodulateAskFixed<8, EnergySse2Fixed<8>>,
+                                    DemodulateAskFixed<16, EnergySse2Fixed<16>>,
+                                    DemodulateAskFixed<32, EnergySse2Fixed<32>> },
+                                  { DemodulatePskFixed<8, CorrelationSse2Fixed<8>>,
+                                    DemodulatePskFixed<16, CorrelationSse2Fixed<16>>,
+                                    DemodulatePskFixed<32, CorrelationSse2Fixed<32>> } };
+constexpr KernelTable kAvx2Table{ Isa::kAvx2, EnergyAvx2, CorrelationAvx2,
+                                  DemodulateAskAvx2, DemodulatePskAvx2,
+                                  { DemodulateAskAvx2Fixed<8>, DemodulateAskAvx2Fixed<16>, DemodulateAskAvx2Fixed<32> },
+                                  { DemodulatePskAvx2Fixed<8>, DemodulatePskAvx2Fixed<16>, DemodulatePskAvx2Fixed<32> } };
+
+bool CpuSupportsAvx2()
+{
+#if defined(_MSC_VER)
+    int info[4]{};
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    const bool has_fma = (info[2] & (1 << 12)) != 0;
+    const bool has_osxsave = (info[2] & (1 << 27)) != 0;
+    const bool has_avx = (info[2] & (1 << 28)) != 0;
+    if (!has_fma || !has_osxsave || !has_avx) {
+        return false;
+    }
+    // 操作系统需保存 YMM 寄存器状态
+    if ((_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+const KernelTable *DetectTable()
+{
+    return CpuSupportsAvx2() ? &kAvx2Table : &kSse2Table;
+}
+
+const KernelTable *TableFor(Isa isa)
+{
+    switch (isa) {
+    case Isa::kAvx2:
+        return CpuSupportsAvx2() ? &kAvx2Table : DetectTable();
+    case Isa::kSse2:
+        return &kSse2Table;
+    case Isa::kScalar:
+        return &kScalarTable;
+    }
+    return DetectTable();
+}
+
+std::atomic<const KernelTable *> active_table{ nullptr };
+
+const KernelTable &Table()
+{
+    auto table = active_table.load(std::memory_order_acquire);
+    if (!table) {
+        table = DetectTable();
+        active_table.store(table, std::memory_order_release);
+    }
+    return *table;
+}
+
+}
+
+Isa ActiveIsa()
+{
+    return Table().isa;
+}
+
+const char *IsaName(Isa isa)
+{
+    switch (isa) {
+    case Isa::kScalar:
+        return "Scalar";
+    case Isa::kSse2:
+        return "SSE2";
+    case Isa::kAvx2:
+        return "AVX2";
+    }
+    return "Unknown";
+}
+
+void ForceIsa(Isa isa)
+{
+    active_table.store(TableFor(isa), std::memory_order_release);
+}
+
+double Energy(const double *samples, qsizetype count)
+{
+    return Table().energy(samples, count);
+}
+
+double Correlation(const double *samples, const double *reference, qsizetype count)
+{
+    return Table().correlation(samples, reference, count);
+}
+
+bool HasFixedKernel(qsizetype samples_per_bit)
+{
+    return FixedIndex(samples_per_bit) >= 0;
+}
+
+void DemodulateAsk(const double *samples, qsizetype bit_count, qsizetype samples_per_bit,
+                   double threshold, uint8_t *packed)
+{
+    const auto &table = Table();
+    const int fixed = FixedIndex(samples_per_bit);
+    if (fixed >= 0) {
+        table.demodulate_ask_fixed[fixed](samples, bit_count, threshold, packed);
+    } else {
+        table.demodulate_ask(samples, bit_count, samples_per_bit, threshold, packed);
+    }
+}
+
+void DemodulatePsk(const double *samples, qsizetype bit_count, qsizetype samples_per_bit,
+                   const double *reference, uint8_t *packed)
+{
+    const auto &table = Table();
+    const int fixed = FixedIndex(samples_per_bit);
+    if (fixed >= 0) {
+        table.demodulate_psk_fixed[fixed](samples, bit_count, reference, packed);
+    } else {
+        table.demodulate_psk(samples, bit_count, samples_per_bit, reference, packed);
+    }
+}
+
+}
@@ -0,0 +1,38 @@
+﻿#pragma once
+
+#include <QtGlobal>
+#include <cstdint>
+
+// 解调内核：标量参考实现与 SSE2/AVX2 向量化实现，运行时按 CPU 能力选择。
+// 每比特 8/16/32 个采样的常用配置另有编译期完全展开的专用版本，批量解调时按参数分派
+namespace DemodKernels {
+
+enum class Isa {
+    kScalar,
+    kSse2,
+    kAvx2
+};
+
+// 当前选中的指令集，首次调用任一内核时检测
+Isa ActiveIsa();
+const char *IsaName(Isa isa);
+// 强制使用指定指令集（用于对照测试），不支持时回退到检测结果
+void ForceIsa(Isa isa);
+
+// 单段采样的能量 sum(x^2)
+double Energy(const double *samples, qsizetype count);
+// 单段采样与参考信号的相关值 sum(x*ref)
+double Correlation(const double *samples, const double *reference, qsizetype count);
+
+// 每比特采样数是否有专用内核
+bool HasFixedKernel(qsizetype samples_per_bit);
+
+// 批量解调 bit_count 个完整比特，每比特 samples_per_bit 个采样。
+// 结果按高位在前打包写入 packed（8 比特一个字节，与 BitStream 布局一致），
+// 末尾不足 8 比特的字节低位补 0
+void DemodulateAsk(const double *samples, qsizetype bit_count, qsizetype samples_per_bit,
+                   double threshold, uint8_t *packed);
+void DemodulatePsk(const double *samples, qsizetype bit_count, qsizetype samples_per_bit,
+                   const double *reference, uint8_t *packed);
+
+}
@@ -3,26 +3,90 @@
 #include <QFileDialog>
 #include <QDir>
 #include <QFileInfo>
+#include <QFontDatabase>
+#include <QScrollBar>
+#include <QMouseEvent>
 
 MainWindow::MainWindow(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::MainWindowClass())
-    , network_model_(new NetworkModel(this))
+    , network_thread_(new QThread(this))
+    , network_model_(new NetworkModel(nullptr))
+    , receive_server_(new ReceiveServer(nullptr))
+    , progress_reporter_(new ProgressReporter(this))
+    , metrics_monitor_(new MetricsMonitor(this))
     , txt_model_(new TxtModel(this))
     , audio_model_(new AudioModel(this))
+    , sample_list_model_(new SampleListModel(this))
+    , bit_list_model_(new BitListModel(this))
 {
     ui->setupUi(this);
-    ui->label_sample_rate->setText(" 采样率: " + QString::number(txt_model_->kSampleRate) + " Hz"
-                                   + "                    "
-                                   + " 传信率: " + QString::number(txt_model_->kSampleRate / txt_model_->kSamplesPerBit) + " bps"
-                                   + "                    "
-                                   + " 载波: " + QString::number(txt_model_->kCarrierFreq) + " Hz");
+    // 采样与比特视图按需格式化可见行，等宽字体保证各行按列对齐
+    const auto fixed_font = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    ui->listView_original->setModel(sample_list_model_);
+    ui->listView_original->setFont(fixed_font);
+    ui->listView_demodulated->setModel(bit_list_model_);
+    ui->listView_demodulated->setFont(fixed_font);
+    ShowModemParams(txt_model_->get_modem_params());
+    // 网络模型移入独立线程，跨线程信号自动以排队方式投递到 UI 线程
+    network_model_->moveToThread(network_thread_);
+    receive_server_->moveToThread(network_thread_);
+    network_thread_->setObjectName("NetworkThread");
+    network_thread_->start();
     // 连接网络模型信号
     connect(network_model_, &NetworkModel::connectionChanged, this, &MainWindow::onConnectionChanged);
+    connect(network_model_, &NetworkModel::connectionRetrying, this, &MainWindow::onConnectionRetrying);
     connect(network_model_, &NetworkModel::fileReceiveStarted, this, &MainWindow::onFileReceiveStarted);
-    connect(network_model_, &NetworkModel::fileReceiveProgress, this, &MainWindow::onFileReceiveProgress);
+    progress_reporter_->set_counters(network_model_->get_receive_counters());
+    connect(progress_reporter_, &ProgressReporter::progressUpdated, this, &MainWindow::onReceiveProgressUpdated);
     connect(network_model_, &NetworkModel::fileReceiveCompleted, this, &MainWindow::onFileReceiveCompleted);
     connect(network_model_, &NetworkModel::fileReceiveError, this, &MainWindow::onFileReceiveError);
+    // 连接服务器模式信号
+    connect(receive_server_, &ReceiveServer::listeningChanged, this, &MainWindow::onListeningChanged);
+    connect(receive_server_, &ReceiveServer::connectionOpened, this, &MainWindow::onServerConnectionOpened);
+    connect(receive_server_, &ReceiveServer::connectionClosed, this, &MainWindow::onServerConnectionClosed);
+    connect(receive_server_, &ReceiveServer::fileReceiveCompleted, this, &MainWindow::onServerFileReceiveCompleted);
+    connect(receive_server_, &ReceiveServer::fileReceiveError, this, &MainWindow::onServerFileReceiveError);
+    connect(receive_server_, &ReceiveServer::statsUpdated, this, &MainWindow::onServerStatsUpdated);
+    ui->label_server_stats->setVisible(false);
+    // 连接流式解调信号
+    const auto stream_demodulator = network_model_->get_stream_demodulator();
+    connect(stream_demodulator, &StreamDemodulator::bitsDemodulated, this, &MainWindow::onStreamBitsDemodulated);
+    connect(stream_demodulator, &StreamDemodulator::textDecoded, this, &MainWindow::onStreamTextDecoded);
+    connect(stream_demodulator, &StreamDemodulator::demodulationError, this, &MainWindow::onStreamDemodulationError);
+    connect(ui->checkBox_stream_demodulate, &QCheckBox::toggled, this, &MainWindow::UpdateStreamDemodulation);
+    connect(ui->comboBox_demodulation, &QComboBox::currentTextChanged, this, &MainWindow::UpdateStreamDemodulation);
+    connect(ui->comboBox_decoding, &QComboBox::currentTextChanged, this, &MainWindow::UpdateStreamDemodulation);
+    // 调制参数修改后同时作用于文件解调与流式解调
+    connect(ui->doubleSpinBox_sample_rate, &QDoubleSpinBox::valueChanged, this, &MainWindow::UpdateModemParams);
+    connect(ui->spinBox_samples_per_bit, &QSpinBox::valueChanged, this, &MainWindow::UpdateModemParams);
+    connect(ui->doubleSpinBox_carrier_freq, &QDoubleSpinBox::valueChanged, this, &MainWindow::UpdateModemParams);
+    connect(ui->checkBox_symbol_sync, &QCheckBox::toggled, ui->lineEdit_preamble, &QLineEdit::setEnabled);
+    connect(ui->checkBox_symbol_sync, &QCheckBox::toggled, this, &MainWindow::UpdateModemParams);
+    connect(ui->lineEdit_preamble, &QLineEdit::editingFinished, this, &MainWindow::UpdateModemParams);
+    // 波形视图的判决量随解调方式切换
+    connect(ui->comboBox_demodulation, &QComboBox::currentIndexChanged, this, [this](int index) {
+        ui->widget_waveform->set_scheme(index == 0 ? DemodEngine::kAsk : DemodEngine::kPsk);
+    });
+    // 流水线统计表：每个阶段一行，计时默认关闭
+    const QStringList metrics_headers{ "次数/s", "MB/s", "条目/s", "平均 us", "最大 us", "占用 %" };
+    ui->tableWidget_metrics->setColumnCount(metrics_headers.size());
+    ui->tableWidget_metrics->setHorizontalHeaderLabels(metrics_headers);
+    ui->tableWidget_metrics->setRowCount(Metrics::kStageCount);
+    QStringList stage_names;
+    for (int stage = 0; stage < Metrics::kStageCount; ++stage) {
+        stage_names << Metrics::StageName(static_cast<Metrics::Stage>(stage));
+        for (int column = 0; column < metrics_headers.size(); ++column) {
+            ui->tableWidget_metrics->setItem(stage, column, new QTableWidgetItem("-"));
+        }
+    }
+    ui->tableWidget_metrics->setVerticalHeaderLabels(stage_names);
+    ui->tableWidget_metrics->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    connect(metrics_monitor_, &MetricsMonitor::metricsUpdated, this, &MainWindow::onMetricsUpdated);
+    // 连接解调进度信号
+    connect(txt_model_, &TxtModel::demodulationProgress, ui->progressBar_demodulate, &QProgressBar::setValue);
+    connect(txt_model_, &TxtModel::demodulationFinished, this, &MainWindow::onDemodulationFinished);
+    connect(txt_model_, &TxtModel::samplesReloaded, this, &MainWindow::onSamplesReloaded);
     // 设置默认保存目录
     QString receive_dir = QDir::currentPath() + "/Received Files";
     QDir dir(receive_dir);
@@ -30,24 +94,44 @@ MainWindow::MainWindow(QWidget *parent)
         dir.mkpath(receive_dir);
     }
     network_model_->set_receive_directory(receive_dir);
+    receive_server_->set_receive_directory(receive_dir);
     
     // 连接音频播放相关信号
     connect(audio_model_, &AudioModel::PlaybackPositionChanged, this, &MainWindow::UpdatePlaybackProgress);
     connect(audio_model_, &AudioModel::PlaybackFinished, this, &MainWindow::OnPlaybackFinished);
+    // 播放进度条可点击或拖动定位
+    ui->progressBar_playback->installEventFilter(this);
+    ui->progressBar_playback->setCursor(Qt::PointingHandCursor);
 }
 
 MainWindow::~MainWindow()
 {
-    // 确保在程序退出前断开连接
-    if (network_model_->IsConnected()) {
-        network_model_->CloseConnection();
-    }
+    // 确保在程序退出前断开连接，并在网络线程中完成清理
+    QMetaObject::invokeMethod(network_model_, &NetworkModel::CloseConnection, Qt::BlockingQueuedConnection);
+    QMetaObject::invokeMethod(receive_server_, &ReceiveServer::Stop, Qt::BlockingQueuedConnection);
+    network_thread_->quit();
+    network_thread_->wait();
+    delete receive_server_;
+    delete network_model_;
     delete ui;
 }
 
 // Button Slots
 void MainWindow::on_btn_connect_clicked(bool checked)
 {
+    // 服务器模式下按钮用于开始/停止监听，IP 留空时监听所有网卡
+    if (ui->checkBox_server_mode->isChecked()) {
+        if (checked) {
+            const auto ip = ui->lineEdit_ip->text();
+            const auto port = ui->lineEdit_port->text();
+            QMetaObject::invokeMethod(receive_server_, [this, ip, port] {
+                receive_server_->Start(ip, port);
+            });
+        } else {
+            QMetaObject::invokeMethod(receive_server_, &ReceiveServer::Stop);
+        }
+        return;
+    }
     if (checked) {
         // 尝试连接
         const auto ip = ui->lineEdit_ip->text();
@@ -57,35 +141,77 @@ void MainWindow::on_btn_connect_clicked(bool checked)
             ui->btn_connect->setChecked(false);
             return;
         }
-        // 开始连接
-        network_model_->StartConnection(ip, port);
+        // 开始异步连接，结果通过 connectionChanged 通知
+        QMetaObject::invokeMethod(network_model_, [this, ip, port] {
+            network_model_->StartConnection(ip, port);
+        });
     } else {
-        // 断开连接
-        network_model_->CloseConnection();
+        // 断开连接，连接过程中点击则取消连接
+        QMetaObject::invokeMethod(network_model_, &NetworkModel::CloseConnection);
     }
 }
 
 void MainWindow::on_btn_load_received_file_clicked()
 {
-    const auto file_name = QFileDialog::getOpenFileName(this, "选择接收的文件", network_model_->get_receive_directory(), "文本文件 (*.txt)");
+    const auto file_name = QFileDialog::getOpenFileName(this, "选择接收的文件", network_model_->get_receive_directory(), "采样文件 (*.txt *.srb *.wav);;文本文件 (*.txt);;二进制采样文件 (*.srb);;WAV音频 (*.wav)");
     if (file_name.isEmpty()) {
         return;
     }
-    if (txt_model_->LoadTxtFile(file_name)) {
-        ui->textBrowser_original->setText(txt_model_->get_txt_received_data());
-        ui->btn_demodulate->setEnabled(true);
+    // 重新加载会替换视图引用的采样与比特缓冲，先断开视图
+    sample_list_model_->Clear();
+    bit_list_model_->Clear();
+    ui->widget_waveform->Clear();
+    // 文本文件按界面参数解调，上一次加载的容器头参数不沿用
+    if (!txt_model_->set_modem_params(CurrentModemParams()) || !txt_model_->LoadTxtFile(file_name)) {
+        QMessageBox::warning(this, "Error", txt_model_->get_error_message());
+        return;
     }
+    // 二进制容器使用文件头中的参数，同步显示到界面
+    ShowModemParams(txt_model_->get_modem_params());
+    sample_list_model_->set_samples(txt_model_->get_txt_modulated_data());
+    ui->widget_waveform->set_samples(txt_model_->get_txt_modulated_data(), txt_model_->get_modem_params());
+    ui->listView_original->setToolTip(txt_model_->get_txt_received_summary());
+    ui->btn_demodulate->setEnabled(true);
 }
 
 void MainWindow::on_btn_demodulate_clicked()
 {
-    txt_model_->DemodulateTxtFile(ui->comboBox_demodulation->currentText());
-    const auto &data = txt_model_->get_txt_demodulated_data();
-    QString str;
-    for (const auto bit : data) {
-        str.append(QString::number(bit));
+    // 解调进行中时按钮用于取消
+    if (txt_model_->IsDemodulating()) {
+        txt_model_->CancelDemodulation();
+        return;
+    }
+    // 解调期间比特缓冲由工作线程写入，视图不能读取
+    bit_list_model_->Clear();
+    if (!txt_model_->StartDemodulation(ui->comboBox_demodulation->currentText())) {
+        return;
     }
-    ui->textBrowser_demodulated->setText(str.trimmed());
+    ui->progressBar_demodulate->setValue(0);
+    ui->btn_demodulate->setText("取消解调");
+    ui->btn_load_received_file->setEnabled(false);
+    ui->btn_decode->setEnabled(false);
+}
+
+void MainWindow::onSamplesReloaded()
+{
+    // WAV 音频按新的采样率重新转换，视图改为引用新的采样缓冲
+    sample_list_model_->Clear();
+    ui->widget_waveform->Clear();
+    sample_list_model_->set_samples(txt_model_->get_txt_modulated_data());
+    ui->widget_waveform->set_samples(txt_model_->get_txt_modulated_data(), txt_model_->get_modem_params());
+    ui->listView_original->setToolTip(txt_model_->get_txt_received_summary());
+}
+
+void MainWindow::onDemodulationFinished(bool canceled)
+{
+    ui->btn_demodulate->setText("开始解调");
+    ui->btn_load_received_file->setEnabled(true);
+    if (canceled) {
+        ui->progressBar_demodulate->setValue(0);
+        return;
+    }
+    ui->progressBar_demodulate->setValue(100);
+    bit_list_model_->set_bits(&txt_model_->get_txt_demodulated_data());
     ui->btn_decode->setEnabled(true);
 }
 
@@ -99,34 +225,39 @@ void MainWindow::on_btn_decode_clicked()
 void MainWindow::on_btn_save_recovered_file_clicked()
 {
     const auto file_name = QFileDialog::getSaveFileName(this, "Save Recovered File", "", "Text Files (*.txt)");
-    if (!file_name.isEmpty()) {
-        txt_model_->SaveRecoverdFile(file_name);
+    if (!file_name.isEmpty() && !txt_model_->SaveRecoverdFile(file_name)) {
+        QMessageBox::warning(this, "Error", txt_model_->get_error_message());
     }
 }
 
 // Network Slots
 void MainWindow::onConnectionChanged(NetworkModel::ConnectionState state)
 {
-    // 恢复按钮可用状态
+    // 恢复按钮可用状态，连接期间不允许切换到服务器模式
     ui->btn_connect->setEnabled(true);
+    ui->checkBox_server_mode->setEnabled(state == NetworkModel::Disconnected || state == NetworkModel::Error);
     switch (state) {
     case NetworkModel::Connected:
         // 只有在真正连接成功时才显示成功信息
         ui->textBrowser_client_info->append("连接成功！");
+        progress_reporter_->Start();
         ui->btn_connect->setText("断开连接");
         ui->btn_connect->setChecked(true);
         break;
     case NetworkModel::Disconnected:
         ui->textBrowser_client_info->append("连接已断开");
+        progress_reporter_->Stop();
         ui->btn_connect->setText("建立连接");
         ui->btn_connect->setChecked(false);
         break;
     case NetworkModel::Connecting:
+        // 连接为异步过程，期间允许用户取消
         ui->textBrowser_client_info->append("正在连接中...");
-        ui->btn_connect->setText("连接中...");
-        ui->btn_connect->setEnabled(false);
+        ui->btn_connect->setText("取消连接");
+        ui->btn_connect->setChecked(true);
         break;
     case NetworkModel::Error:
+        progress_reporter_->Stop();
         QString error = network_model_->get_error_message();
         ui->textBrowser_client_info->append("连接失败: " + error);
         QMessageBox::warning(this, "连接失败", error);
@@ -136,26 +267,36 @@ void MainWindow::onConnectionChanged(NetworkModel::ConnectionState state)
     }
 }
 
+void MainWindow::onConnectionRetrying(int attempt, int max_retries, int delay_ms, const QString &reason)
+{
+    ui->textBrowser_client_info->append(QString("连接失败: %1，%2 毫秒后第 %3/%4 次重试")
+                                       .arg(reason)
+                                       .arg(delay_ms)
+                                       .arg(attempt)
+                                       .arg(max_retries));
+}
+
 void MainWindow::onFileReceiveStarted(const QString &file_name, qint64 file_size)
 {
     ui->textBrowser_client_info->append(QString("开始接收文件: %1 (大小: %2 字节)")
                                        .arg(file_name)
                                        .arg(file_size));
+    if (ui->checkBox_stream_demodulate->isChecked()) {
+        bit_list_model_->Clear();
+        ui->textBrowser_decoded->clear();
+    }
 }
 
-void MainWindow::onFileReceiveProgress(qint64 bytes_received, qint64 total_bytes)
+void MainWindow::onReceiveProgressUpdated(const ProgressReporter::Snapshot &snapshot)
 {
-    int progress = static_cast<int>((bytes_received * 100) / total_bytes);
-    ui->textBrowser_client_info->append(QString("接收进度: %1% (%2/%3 字节)")
-                                       .arg(progress)
-                                       .arg(bytes_received)
-                                       .arg(total_bytes));
+    ui->progressBar_receive->setValue(snapshot.percent);
+    ui->label_receive_progress->setText(ProgressReporter::FormatSnapshot(snapshot));
 }
 
 void MainWindow::onFileReceiveCompleted(const QString &saved_file_path)
 {
+    // 同一会话中可能连续收到大量文件，只记录日志不弹出模态对话框
     ui->textBrowser_client_info->append("文件接收完成，已保存到: " + saved_file_path);
-    QMessageBox::information(this, "文件接收完成", "文件已成功保存到:\n" + saved_file_path);
 }
 
 void MainWindow::onFileReceiveError(const QString &error_message)
@@ -164,6 +305,189 @@ void MainWindow::onFileReceiveError(const QString &error_message)
     QMessageBox::warning(this, "文件接收错误", error_message);
 }
 
+void MainWindow::on_checkBox_server_mode_toggled(bool checked)
+{
+    ui->btn_connect->setText(checked ? "开始监听" : "建立连接");
+    ui->label_server_stats->setVisible(checked);
+}
+
+void MainWindow::onListeningChanged(bool listening)
+{
+    ui->btn_connect->setChecked(listening);
+    ui->btn_connect->setText(listening ? "停止监听" : "开始监听");
+    // 监听期间不允许切换模式
+    ui->checkBox_server_mode->setEnabled(!listening);
+    if (listening) {
+        ui->textBrowser_client_info->append("开始监听端口 " + ui->lineEdit_port->text());
+        return;
+    }
+    const auto error = receive_server_->get_error_message();
+    if (error.isEmpty()) {
+        ui->textBrowser_client_info->append("已停止监听");
+    } else {
+        ui->textBrowser_client_info->append("监听失败: " + error);
+        QMessageBox::warning(this, "监听失败", error);
+    }
+}
+
+void MainWindow::onServerConnectionOpened(quint64 connection_id, const QString &peer)
+{
+    ui->textBrowser_client_info->append(QString("发送端 #%1 已连接: %2").arg(connection_id).arg(peer));
+}
+
+void MainWindow::onServerConnectionClosed(quint64 connection_id, const QString &peer)
+{
+    ui->textBrowser_client_info->append(QString("发送端 #%1 已断开: %2").arg(connection_id).arg(peer));
+}
+
+void MainWindow::onServerFileReceiveCompleted(const QString &peer, const QString &saved_file_path)
+{
+    ui->textBrowser_client_info->append(QString("[%1] 文件接收完成，已保存到: %2").arg(peer, saved_file_path));
+}
+
+void MainWindow::onServerFileReceiveError(const QString &peer, const QString &error_message)
+{
+    // 多发送端场景下错误只记录日志，不弹窗打断
+    ui->textBrowser_client_info->append(QString("[%1] 文件接收错误: %2").arg(peer, error_message));
+}
+
+void MainWindow::onServerStatsUpdated(int connection_count, qint64 total_bytes, double bytes_per_second)
+{
+    ui->label_server_stats->setText(QString("连接数: %1    累计: %2 MB    吞吐: %3 MB/s")
+                                    .arg(connection_count)
+                                    .arg(total_bytes / (1024 * 1024))
+                                    .arg(bytes_per_second / (1024 * 1024), 0, 'f', 2));
+}
+
+void MainWindow::on_checkBox_metrics_enabled_toggled(bool checked)
+{
+    if (checked) {
+        metrics_monitor_->Start();
+    } else {
+        metrics_monitor_->Stop();
+        ui->btn_metrics_export->setChecked(false);
+        ui->btn_metrics_export->setText("开始导出");
+    }
+    ui->btn_metrics_export->setEnabled(checked);
+    ui->comboBox_metrics_format->setEnabled(!metrics_monitor_->IsExporting());
+}
+
+void MainWindow::on_btn_metrics_export_clicked(bool checked)
+{
+    if (!checked) {
+        metrics_monitor_->StopExport();
+        ui->btn_metrics_export->setText("开始导出");
+        ui->comboBox_metrics_format->setEnabled(true);
+        return;
+    }
+    const bool csv = ui->comboBox_metrics_format->currentIndex() == 1;
+    const QString file_name = QFileDialog::getSaveFileName(this, "导出流水线统计", QDir::currentPath(),
+                                                           csv ? "CSV 文件 (*.csv)" : "JSON Lines 文件 (*.jsonl)");
+    if (file_name.isEmpty()) {
+        ui->btn_metrics_export->setChecked(false);
+        return;
+    }
+    if (!metrics_monitor_->StartExport(file_name, csv ? MetricsMonitor::kCsv : MetricsMonitor::kJson)) {
+        ui->btn_metrics_export->setChecked(false);
+        QMessageBox::warning(this, "导出失败", metrics_monitor_->get_error_message());
+        return;
+    }
+    ui->btn_metrics_export->setText("停止导出");
+    ui->comboBox_metrics_format->setEnabled(false);
+}
+
+void MainWindow::onMetricsUpdated(const MetricsMonitor::Rates &rates, const Metrics::Snapshot &totals)
+{
+    Q_UNUSED(totals);
+    for (int stage = 0; stage < Metrics::kStageCount; ++stage) {
+        const auto &rate = rates[stage];
+        const QList<double> values{ rate.calls_per_second, rate.megabytes_per_second, rate.items_per_second,
+                                    rate.mean_us, rate.max_us, rate.busy_percent };
+        for (qsizetype column = 0; column < values.size(); ++column) {
+            ui->tableWidget_metrics->item(stage, column)->setText(QString::number(values[column], 'f', 1));
+        }
+    }
+}
+
+void MainWindow::onStreamBitsDemodulated(const BitStream &bits)
+{
+    // 只在视图已位于末尾时跟随滚动，便于回看之前的比特
+    const auto scroll_bar = ui->listView_demodulated->verticalScrollBar();
+    const bool follow = scroll_bar->value() == scroll_bar->maximum();
+    bit_list_model_->Append(bits);
+    if (follow) {
+        ui->listView_demodulated->scrollToBottom();
+    }
+}
+
+void MainWindow::onStreamTextDecoded(const QString &text)
+{
+    ui->textBrowser_decoded->moveCursor(QTextCursor::End);
+    ui->textBrowser_decoded->insertPlainText(text);
+}
+
+void MainWindow::onStreamDemodulationError(const QString &error_message)
+{
+    // 文件接收本身不受影响，只停止本次流式解调
+    ui->textBrowser_client_info->append("流式解调已停止: " + error_message);
+}
+
+void MainWindow::UpdateStreamDemodulation()
+{
+    network_model_->set_stream_demodulation(ui->checkBox_stream_demodulate->isChecked(),
+                                            ui->comboBox_demodulation->currentText(),
+                                            ui->comboBox_decoding->currentText(),
+                                            CurrentModemParams());
+}
+
+void MainWindow::UpdateModemParams()
+{
+    const auto params = CurrentModemParams();
+    QString error;
+    QByteArray preamble;
+    if (!ModemParams::ParsePreamble(ui->lineEdit_preamble->text(), preamble, &error) || !params.Validate(&error)) {
+        ui->label_sample_rate->setText(" 调制参数无效: " + error);
+        return;
+    }
+    // 解调进行中时模型拒绝修改，完成后再次修改即可生效
+    txt_model_->set_modem_params(params);
+    ui->widget_waveform->set_modem_params(params);
+    ShowModemParams(params);
+    UpdateStreamDemodulation();
+}
+
+ModemParams MainWindow::CurrentModemParams() const
+{
+    ModemParams params;
+    params.sample_rate = ui->doubleSpinBox_sample_rate->value();
+    params.samples_per_bit = ui->spinBox_samples_per_bit->value();
+    params.carrier_freq = ui->doubleSpinBox_carrier_freq->value();
+    params.symbol_sync = ui->checkBox_symbol_sync->isChecked();
+    // 前导码格式错误时按空处理，由 UpdateModemParams 提示
+    ModemParams::ParsePreamble(ui->lineEdit_preamble->text(), params.preamble);
+    return params;
+}
+
+void MainWindow::ShowModemParams(const ModemParams &params)
+{
+    // 程序内同步参数时不触发修改信号
+    const QSignalBlocker sample_rate_blocker(ui->doubleSpinBox_sample_rate);
+    const QSignalBlocker samples_per_bit_blocker(ui->spinBox_samples_per_bit);
+    const QSignalBlocker carrier_freq_blocker(ui->doubleSpinBox_carrier_freq);
+    const QSignalBlocker symbol_sync_blocker(ui->checkBox_symbol_sync);
+    ui->doubleSpinBox_sample_rate->setValue(params.sample_rate);
+    ui->spinBox_samples_per_bit->setValue(params.samples_per_bit);
+    ui->doubleSpinBox_carrier_freq->setValue(params.carrier_freq);
+    ui->checkBox_symbol_sync->setChecked(params.symbol_sync);
+    ui->lineEdit_preamble->setEnabled(params.symbol_sync);
+    ui->lineEdit_preamble->setText(params.PreambleText());
+    ui->label_sample_rate->setText(" 采样率: " + QString::number(params.sample_rate) + " Hz"
+                                   + "                    "
+                                   + " 传信率: " + QString::number(params.BitRate()) + " bps"
+                                   + "                    "
+                                   + " 载波: " + QString::number(params.carrier_freq) + " Hz");
+}
+
 // 音频播放功能相关
 void MainWindow::on_btn_open_recorded_file_clicked()
 {
@@ -173,27 +497,26 @@ void MainWindow::on_btn_open_recorded_file_clicked()
     }
     ui->lineEdit_wav_file_path->setText(file_name);
     if (audio_model_->LoadWavFile(file_name)) {
-        const int total_duration = audio_model_->get_playback_total_duration();
-        const int minutes = total_duration / 60;
-        const int seconds = total_duration % 60;
-
-        ui->label_playback->setText(QString("00:00 / %1:%2")
-                                    .arg(minutes, 2, 10, QChar('0'))
-                                    .arg(seconds, 2, 10, QChar('0')));
-        ui->progressBar_playback->setValue(0);
+        const qint64 duration_ms = audio_model_->get_playback_duration_ms();
+        ui->progressBar_playback->setRange(0, static_cast<int>(duration_ms));
+        UpdatePlaybackProgress(0, duration_ms);
 
+        const auto &info = audio_model_->get_wav_info();
         QMessageBox::information(this, "文件加载成功",
-                                QString("WAV文件已加载: %1\n时长: %2:%3")
+                                QString("WAV文件已加载: %1\n时长: %2\n格式: %3, %4 声道, %5 Hz")
                                 .arg(QFileInfo(file_name).fileName())
-                                .arg(minutes, 2, 10, QChar('0'))
-                                .arg(seconds, 2, 10, QChar('0')));
+                                .arg(FormatPlaybackTime(duration_ms))
+                                .arg(WavFile::EncodingName(info.encoding))
+                                .arg(info.channel_count)
+                                .arg(info.sample_rate));
         
         ui->btn_play_wav->setEnabled(true);
         ui->btn_pause_wav->setEnabled(false);
         ui->btn_close_wav->setEnabled(false);
     } else {
         ui->lineEdit_wav_file_path->clear();
-        QMessageBox::warning(this, "文件加载失败", "无法加载WAV文件，请检查文件格式。");
+        ui->progressBar_playback->setRange(0, 100);
+        QMessageBox::warning(this, "文件加载失败", "无法加载WAV文件: " + audio_model_->get_error_message());
     }
 }
 
@@ -209,7 +532,7 @@ void MainWindow::on_btn_play_wav_clicked()
         ui->btn_close_wav->setEnabled(true);
         ui->btn_open_recorded_file->setEnabled(false);
     } else {
-        QMessageBox::warning(this, "播放失败", "无法开始播放，请检查音频文件和设备状态。");
+        QMessageBox::warning(this, "播放失败", "无法开始播放: " + audio_model_->get_error_message());
     }
 }
 
@@ -229,23 +552,58 @@ void MainWindow::on_btn_close_wav_clicked()
     OnPlaybackFinished();
 }
 
-void MainWindow::UpdatePlaybackProgress(int current_seconds, int total_seconds)
+void MainWindow::UpdatePlaybackProgress(qint64 position_ms, qint64 duration_ms)
+{
+    // 拖动进度条期间由拖动位置决定显示，忽略播放位置上报
+    if (playback_scrubbing_) {
+        return;
+    }
+    ShowPlaybackPosition(position_ms, duration_ms);
+}
+
+void MainWindow::ShowPlaybackPosition(qint64 position_ms, qint64 duration_ms)
+{
+    ui->label_playback->setText(FormatPlaybackTime(position_ms) + " / " + FormatPlaybackTime(duration_ms));
+    ui->progressBar_playback->setValue(static_cast<int>(position_ms));
+}
+
+QString MainWindow::FormatPlaybackTime(qint64 ms)
+{
+    const qint64 total_seconds = ms / 1000;
+    return QString("%1:%2")
+        .arg(total_seconds / 60, 2, 10, QChar('0'))
+        .arg(total_seconds % 60, 2, 10, QChar('0'));
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
 {
-    const int current_minutes = current_seconds / 60;
-    const int current_secs = current_seconds % 60;
-    const int total_minutes = total_seconds / 60;
-    const int total_secs = total_seconds % 60;
-    // 更新时间标签
-    ui->label_playback->setText(QString("%1:%2 / %3:%4")
-                                .arg(current_minutes, 2, 10, QChar('0'))
-                                .arg(current_secs, 2, 10, QChar('0'))
-                                .arg(total_minutes, 2, 10, QChar('0'))
-                                .arg(total_secs, 2, 10, QChar('0')));
-    // 更新进度条
-    if (total_seconds > 0) {
-        const int progress = (current_seconds * 100) / total_seconds;
-        ui->progressBar_playback->setValue(progress);
+    // 在播放进度条上按下或拖动时预览位置，松开时定位；未播放时定位作为下次播放的起点
+    const qint64 duration_ms = audio_model_->get_playback_duration_ms();
+    if (watched != ui->progressBar_playback || duration_ms <= 0) {
+        return QWidget::eventFilter(watched, event);
+    }
+    const auto type = event->type();
+    if (type != QEvent::MouseButtonPress && type != QEvent::MouseMove && type != QEvent::MouseButtonRelease) {
+        return QWidget::eventFilter(watched, event);
+    }
+    const auto *mouse_event = static_cast<QMouseEvent *>(event);
+    if (type == QEvent::MouseButtonPress && mouse_event->button() == Qt::LeftButton) {
+        playback_scrubbing_ = true;
+    }
+    if (!playback_scrubbing_) {
+        return QWidget::eventFilter(watched, event);
+    }
+    const int width = qMax(1, ui->progressBar_playback->width());
+    const double ratio = qBound(0.0, mouse_event->position().x() / width, 1.0);
+    const qint64 position_ms = static_cast<qint64>(ratio * duration_ms);
+    ShowPlaybackPosition(position_ms, duration_ms);
+    if (type == QEvent::MouseButtonRelease) {
+        playback_scrubbing_ = false;
+        if (!audio_model_->SeekPlayback(position_ms)) {
+            QMessageBox::warning(this, "定位失败", audio_model_->get_error_message());
+        }
     }
+    return true;
 }
 
 void MainWindow::OnPlaybackFinished()
@@ -255,12 +613,6 @@ void MainWindow::OnPlaybackFinished()
     ui->btn_close_wav->setEnabled(false);
     ui->btn_pause_wav->setText("暂停");
     ui->btn_open_recorded_file->setEnabled(true);
-    ui->progressBar_playback->setValue(0);
-
-    const int total_duration = audio_model_->get_playback_total_duration();
-    const int minutes = total_duration / 60;
-    const int seconds = total_duration % 60;
-    ui->label_playback->setText(QString("00:00 / %1:%2")
-                                .arg(minutes, 2, 10, QChar('0'))
-                                .arg(seconds, 2, 10, QChar('0')));
+    playback_scrubbing_ = false;
+    ShowPlaybackPosition(0, audio_model_->get_playback_duration_ms());
 }
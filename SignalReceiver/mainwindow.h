@@ -1,8 +1,14 @@
 ﻿#pragma once
 
 #include <QtWidgets/QWidget>
+#include <QThread>
 #include "ui_mainwindow.h"
 #include "networkmodel.h"
+#include "receiveserver.h"
+#include "progressreporter.h"
+#include "metricsmonitor.h"
+#include "samplelistmodel.h"
+#include "bitlistmodel.h"
 #include "txtmodel.h"
 #include "audiomodel.h"
 
@@ -18,24 +24,60 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private slots:
     void on_btn_connect_clicked(bool checked);
     void onConnectionChanged(NetworkModel::ConnectionState state);
+    void onConnectionRetrying(int attempt, int max_retries, int delay_ms, const QString &reason);
     void onFileReceiveStarted(const QString &file_name, qint64 file_size);
-    void onFileReceiveProgress(qint64 bytes_received, qint64 total_bytes);
+    void onReceiveProgressUpdated(const ProgressReporter::Snapshot &snapshot);
     void onFileReceiveCompleted(const QString &saved_file_path);
     void onFileReceiveError(const QString &error_message);
+    void onStreamBitsDemodulated(const BitStream &bits);
+    void onStreamTextDecoded(const QString &text);
+    void onStreamDemodulationError(const QString &error_message);
+    void UpdateStreamDemodulation();
+    void UpdateModemParams();
+    // 服务器模式相关
+    void on_checkBox_server_mode_toggled(bool checked);
+    void onListeningChanged(bool listening);
+    void onServerConnectionOpened(quint64 connection_id, const QString &peer);
+    void onServerConnectionClosed(quint64 connection_id, const QString &peer);
+    void onServerFileReceiveCompleted(const QString &peer, const QString &saved_file_path);
+    void onServerFileReceiveError(const QString &peer, const QString &error_message);
+    void onServerStatsUpdated(int connection_count, qint64 total_bytes, double bytes_per_second);
+    // 流水线统计相关
+    void on_checkBox_metrics_enabled_toggled(bool checked);
+    void on_btn_metrics_export_clicked(bool checked);
+    void onMetricsUpdated(const MetricsMonitor::Rates &rates, const Metrics::Snapshot &totals);
+
+private:
+    ModemParams CurrentModemParams() const;
+    void ShowModemParams(const ModemParams &params);
+    void ShowPlaybackPosition(qint64 position_ms, qint64 duration_ms);
+    static QString FormatPlaybackTime(qint64 ms);
 
 private:
     Ui::MainWindowClass *ui;
+    QThread *network_thread_;       // 网络接收线程，网络模型的全部 socket I/O 与文件写入都在其中进行
     NetworkModel *network_model_;
+    ReceiveServer *receive_server_;        // 服务器模式，与网络模型同在网络线程，连接本身分布在其工作线程池中
+    ProgressReporter *progress_reporter_;  // 按固定频率采样接收进度，更新单个进度条
+    MetricsMonitor *metrics_monitor_;      // 按固定周期汇总热路径计时，更新统计表并导出
     TxtModel *txt_model_;
     AudioModel *audio_model_;
+    SampleListModel *sample_list_model_;   // 原始采样视图，只格式化可见行
+    BitListModel *bit_list_model_;         // 解调比特视图，文件与流式解调共用
+    bool playback_scrubbing_{ false };     // 正在拖动播放进度条
 
 private slots:
     // 文本操作相关
     void on_btn_load_received_file_clicked();
     void on_btn_demodulate_clicked();
+    void onDemodulationFinished(bool canceled);
+    void onSamplesReloaded();
     void on_btn_decode_clicked();
     void on_btn_save_recovered_file_clicked();
     
@@ -44,6 +86,6 @@ private slots:
     void on_btn_play_wav_clicked();
     void on_btn_pause_wav_clicked();
     void on_btn_close_wav_clicked();
-    void UpdatePlaybackProgress(int current_seconds, int total_seconds);
+    void UpdatePlaybackProgress(qint64 position_ms, qint64 duration_ms);
     void OnPlaybackFinished();
 };
@@ -0,0 +1,59 @@
+﻿#include "mappedfile.h"
+
+MappedFile::MappedFile()
+{}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const QString &file_name)
+{
+    Close();
+    file_.setFileName(file_name);
+    if (!file_.open(QIODevice::ReadOnly)) {
+        error_message_ = file_.errorString();
+        return false;
+    }
+    size_ = file_.size();
+    if (size_ == 0) {
+        return true;
+    }
+    mapped_ = file_.map(0, size_);
+    if (mapped_) {
+        data_ = reinterpret_cast<const char *>(mapped_);
+    } else {
+        // 无法映射时回退为读取到内存
+        fallback_data_ = file_.readAll();
+        if (fallback_data_.size() != size_) {
+            error_message_ = file_.errorString();
+            Close();
+            return false;
+        }
+        data_ = fallback_data_.constData();
+    }
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (mapped_) {
+        file_.unmap(mapped_);
+        mapped_ = nullptr;
+    }
+    if (file_.isOpen()) {
+        file_.close();
+    }
+    fallback_data_.clear();
+    data_ = nullptr;
+    size_ = 0;
+}
+
+QByteArray MappedFile::RawData(qint64 offset, qint64 length) const
+{
+    if (offset < 0 || offset >= size_ || length <= 0) {
+        return QByteArray();
+    }
+    return QByteArray::fromRawData(data_ + offset, qMin(length, size_ - offset));
+}
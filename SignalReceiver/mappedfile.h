@@ -0,0 +1,36 @@
+﻿#pragma once
+
+#include <QFile>
+#include <QByteArray>
+#include <QString>
+
+// 只读内存映射文件：基于 QFile::map，数据直接在映射区中访问，不复制到堆上；
+// 映射失败（如部分网络文件系统）时回退为一次性读取
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool Open(const QString &file_name);
+    void Close();
+
+    bool IsOpen() const { return file_.isOpen(); }
+    const char *data() const { return data_; }
+    qint64 size() const { return size_; }
+    // 不复制数据的 QByteArray 视图，生命周期不得超过本对象
+    QByteArray RawData(qint64 offset, qint64 length) const;
+    QString get_file_name() const { return file_.fileName(); }
+    QString get_error_message() const { return error_message_; }
+
+private:
+    QFile file_;
+    uchar *mapped_{ nullptr };
+    QByteArray fallback_data_;
+    const char *data_{ nullptr };
+    qint64 size_{ 0 };
+    QString error_message_;
+};
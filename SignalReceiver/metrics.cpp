@@ -0,0 +1,137 @@
+﻿#include "metrics.h"
+#include <QMutex>
+#include <QList>
+#include <memory>
+
+namespace Metrics {
+
+namespace Detail {
+std::atomic<bool> enabled{ false };
+}
+
+namespace {
+
+// 单个线程的计数槽：只有所属线程写入，其他线程只读，全部使用 relaxed 原子操作
+struct alignas(64) ThreadSlot {
+    struct Counter {
+        std::atomic<quint64> count{ 0 };
+        std::atomic<quint64> total_ns{ 0 };
+        std::atomic<quint64> max_ns{ 0 };
+        std::atomic<quint64> bytes{ 0 };
+        std::atomic<quint64> items{ 0 };
+    };
+    std::array<Counter, kStageCount> counters;
+};
+
+// 线程退出后其槽仍保留在登记表中，累计值不会丢失
+struct Registry {
+    QMutex mutex;
+    QList<std::shared_ptr<ThreadSlot>> slots;
+};
+
+Registry &GetRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+ThreadSlot &LocalSlot()
+{
+    thread_local std::shared_ptr<ThreadSlot> slot = [] {
+        auto new_slot = std::make_shared<ThreadSlot>();
+        auto &registry = GetRegistry();
+        QMutexLocker locker(&registry.mutex);
+        registry.slots.append(new_slot);
+        return new_slot;
+    }();
+    return *slot;
+}
+
+void Add(std::atomic<quint64> &counter, quint64 value)
+{
+    // 单写者，无需原子读改写
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+}
+
+void SetEnabled(bool enabled)
+{
+    Detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool IsEnabled()
+{
+    return Detail::enabled.load(std::memory_order_relaxed);
+}
+
+const char *StageName(Stage stage)
+{
+    switch (stage) {
+    case kSocketRead:
+        return "socket_read";
+    case kFileWrite:
+        return "file_write";
+    case kParse:
+        return "parse";
+    case kDemodulate:
+        return "demodulate";
+    case kDecode:
+        return "decode";
+    default:
+        return "unknown";
+    }
+}
+
+void Record(Stage stage, quint64 elapsed_ns, quint64 bytes, quint64 items)
+{
+    auto &counter = LocalSlot().counters[stage];
+    Add(counter.count, 1);
+    Add(counter.total_ns, elapsed_ns);
+    Add(counter.bytes, bytes);
+    Add(counter.items, items);
+    // 读取方清零时可能与此处竞争而丢失一次峰值，对统计用途可以接受
+    if (elapsed_ns > counter.max_ns.load(std::memory_order_relaxed)) {
+        counter.max_ns.store(elapsed_ns, std::memory_order_relaxed);
+    }
+}
+
+Snapshot TakeSnapshot(bool reset_max)
+{
+    Snapshot snapshot{};
+    auto &registry = GetRegistry();
+    QMutexLocker locker(&registry.mutex);
+    for (const auto &slot : std::as_const(registry.slots)) {
+        for (int stage{ 0 }; stage < kStageCount; ++stage) {
+            auto &counter = slot->counters[stage];
+            auto &totals = snapshot[stage];
+            totals.count += counter.count.load(std::memory_order_relaxed);
+            totals.total_ns += counter.total_ns.load(std::memory_order_relaxed);
+            totals.bytes += counter.bytes.load(std::memory_order_relaxed);
+            totals.items += counter.items.load(std::memory_order_relaxed);
+            const auto max_ns = reset_max ? counter.max_ns.exchange(0, std::memory_order_relaxed)
+                                          : counter.max_ns.load(std::memory_order_relaxed);
+            totals.max_ns = qMax(totals.max_ns, max_ns);
+        }
+    }
+    return snapshot;
+}
+
+StageRates ComputeRates(const StageTotals &previous, const StageTotals &current, double seconds)
+{
+    StageRates rates;
+    if (seconds <= 0.0) {
+        return rates;
+    }
+    const auto calls = current.count - previous.count;
+    const auto total_ns = current.total_ns - previous.total_ns;
+    rates.calls_per_second = calls / seconds;
+    rates.megabytes_per_second = (current.bytes - previous.bytes) / (1024.0 * 1024.0) / seconds;
+    rates.items_per_second = (current.items - previous.items) / seconds;
+    rates.mean_us = calls > 0 ? total_ns / 1000.0 / calls : 0.0;
+    rates.max_us = current.max_ns / 1000.0;
+    rates.busy_percent = total_ns / 1e9 / seconds * 100.0;
+    return rates;
+}
+
+}
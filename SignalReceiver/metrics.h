@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include <QtGlobal>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <chrono>
+
+// 热路径度量：各线程各自累加到本线程的计数槽中，只有单个写者，不存在锁与缓存行争用；
+// 读取时汇总所有线程的槽。关闭时 ScopedTimer 只读取一次全局开关
+namespace Metrics {
+
+enum Stage {
+    kSocketRead,
+    kFileWrite,
+    kParse,
+    kDemodulate,
+    kDecode,
+    kStageCount
+};
+
+struct StageTotals {
+    quint64 count{ 0 };         // 调用次数
+    quint64 total_ns{ 0 };      // 累计耗时
+    quint64 max_ns{ 0 };        // 上次读取以来的最大单次耗时
+    quint64 bytes{ 0 };         // 处理的数据量（字节）
+    quint64 items{ 0 };         // 处理的条目数（采样、比特或字符）
+};
+
+using Snapshot = std::array<StageTotals, kStageCount>;
+
+// 两次快照之间的速率
+struct StageRates {
+    double calls_per_second{ 0.0 };
+    double megabytes_per_second{ 0.0 };
+    double items_per_second{ 0.0 };
+    double mean_us{ 0.0 };
+    double max_us{ 0.0 };
+    double busy_percent{ 0.0 };  // 累计耗时占时间窗的比例，多线程时可超过 100
+};
+
+void SetEnabled(bool enabled);
+bool IsEnabled();
+const char *StageName(Stage stage);
+
+void Record(Stage stage, quint64 elapsed_ns, quint64 bytes, quint64 items);
+// reset_max 为 true 时清零各槽的最大耗时，使下一次快照只反映新时间窗内的峰值
+Snapshot TakeSnapshot(bool reset_max);
+StageRates ComputeRates(const StageTotals &previous, const StageTotals &current, double seconds);
+
+namespace Detail {
+extern std::atomic<bool> enabled;
+}
+
+// 作用域计时器：构造时开关关闭则不计时，析构时记录到本线程的槽中
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(Stage stage, quint64 bytes = 0, quint64 items = 0)
+        : stage_(stage)
+        , bytes_(bytes)
+        , items_(items)
+        , active_(Detail::enabled.load(std::memory_order_relaxed))
+    {
+        if (active_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+    ~ScopedTimer()
+    {
+        if (active_) {
+            const auto elapsed = std::chrono::steady_clock::now() - start_;
+            Record(stage_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), bytes_, items_);
+        }
+    }
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    // 数据量在计时结束前才确定时使用
+    void set_bytes(quint64 bytes) { bytes_ = bytes; }
+    void set_items(quint64 items) { items_ = items; }
+
+private:
+    Stage stage_;
+    quint64 bytes_;
+    quint64 items_;
+    bool active_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+}
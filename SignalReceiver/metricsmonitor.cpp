@@ -0,0 +1,120 @@
+﻿#include "metricsmonitor.h"
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+
+MetricsMonitor::MetricsMonitor(QObject *parent)
+    : QObject(parent)
+    , sample_timer_(new QTimer(this))
+{
+    connect(sample_timer_, &QTimer::timeout, this, &MetricsMonitor::Sample);
+}
+
+void MetricsMonitor::Start(int interval_ms)
+{
+    Metrics::SetEnabled(true);
+    // 以当前累计值为基准，避免第一个周期包含启用前的历史数据
+    last_snapshot_ = Metrics::TakeSnapshot(true);
+    sample_clock_.start();
+    sample_timer_->start(interval_ms);
+}
+
+void MetricsMonitor::Stop()
+{
+    sample_timer_->stop();
+    Metrics::SetEnabled(false);
+    StopExport();
+}
+
+bool MetricsMonitor::StartExport(const QString &file_name, ExportFormat format)
+{
+    StopExport();
+    export_file_.setFileName(file_name);
+    if (!export_file_.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        error_message_ = "无法打开导出文件: " + export_file_.errorString();
+        return false;
+    }
+    export_format_ = format;
+    if (export_format_ == kCsv) {
+        export_file_.write("timestamp,stage,calls_per_second,megabytes_per_second,items_per_second,"
+                           "mean_us,max_us,busy_percent,count,total_ns,bytes,items\n");
+    }
+    export_file_.flush();
+    return true;
+}
+
+void MetricsMonitor::StopExport()
+{
+    if (export_file_.isOpen()) {
+        export_file_.close();
+    }
+}
+
+void MetricsMonitor::Sample()
+{
+    const double elapsed_seconds = sample_clock_.restart() / 1000.0;
+    const auto snapshot = Metrics::TakeSnapshot(true);
+    Rates rates;
+    for (int stage = 0; stage < Metrics::kStageCount; ++stage) {
+        rates[stage] = Metrics::ComputeRates(last_snapshot_[stage], snapshot[stage], elapsed_seconds);
+    }
+    last_snapshot_ = snapshot;
+    if (export_file_.isOpen()) {
+        WriteExport(rates, snapshot);
+    }
+    emit metricsUpdated(rates, snapshot);
+}
+
+void MetricsMonitor::WriteExport(const Rates &rates, const Metrics::Snapshot &totals)
+{
+    const QString timestamp = QDateTime::currentDateTime().toString(Qt::ISODateWithMs);
+    if (export_format_ == kCsv) {
+        QByteArray rows;
+        for (int stage = 0; stage < Metrics::kStageCount; ++stage) {
+            const auto &rate = rates[stage];
+            const auto &total = totals[stage];
+            rows += QString("%1,%2,%3,%4,%5,%6,%7,%8,%9,%10,%11,%12\n")
+                .arg(timestamp, Metrics::StageName(static_cast<Metrics::Stage>(stage)))
+                .arg(rate.calls_per_second, 0, 'f', 1)
+                .arg(rate.megabytes_per_second, 0, 'f', 3)
+                .arg(rate.items_per_second, 0, 'f', 1)
+                .arg(rate.mean_us, 0, 'f', 2)
+                .arg(rate.max_us, 0, 'f', 2)
+                .arg(rate.busy_percent, 0, 'f', 1)
+                .arg(total.count)
+                .arg(total.total_ns)
+                .arg(total.bytes)
+                .arg(total.items)
+                .toUtf8();
+        }
+        export_file_.write(rows);
+    } else {
+        // 每个周期一行 JSON 对象（JSON Lines），文件可随时截断读取
+        QJsonArray stages;
+        for (int stage = 0; stage < Metrics::kStageCount; ++stage) {
+            const auto &rate = rates[stage];
+            const auto &total = totals[stage];
+            QJsonObject object;
+            object["stage"] = Metrics::StageName(static_cast<Metrics::Stage>(stage));
+            object["calls_per_second"] = rate.calls_per_second;
+            object["megabytes_per_second"] = rate.megabytes_per_second;
+            object["items_per_second"] = rate.items_per_second;
+            object["mean_us"] = rate.mean_us;
+            object["max_us"] = rate.max_us;
+            object["busy_percent"] = rate.busy_percent;
+            object["count"] = static_cast<qint64>(total.count);
+            object["total_ns"] = static_cast<qint64>(total.total_ns);
+            object["bytes"] = static_cast<qint64>(total.bytes);
+            object["items"] = static_cast<qint64>(total.items);
+            stages.append(object);
+        }
+        QJsonObject line;
+        line["timestamp"] = timestamp;
+        line["stages"] = stages;
+        export_file_.write(QJsonDocument(line).toJson(QJsonDocument::Compact) + '\n');
+    }
+    // 及时落盘，进程异常退出时保留已导出的周期
+    export_file_.flush();
+}
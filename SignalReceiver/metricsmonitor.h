@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QFile>
+#include <array>
+#include "metrics.h"
+
+// 度量采样器：在 UI 线程中按固定周期汇总各线程的度量槽，计算本周期的速率后发出一次更新；
+// 启用导出时同时把每个周期的结果追加写入 JSON Lines 或 CSV 文件，便于事后定位吞吐下降与卡顿
+class MetricsMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Rates = std::array<Metrics::StageRates, Metrics::kStageCount>;
+
+    enum ExportFormat {
+        kJson,
+        kCsv
+    };
+
+    MetricsMonitor(QObject *parent);
+
+    void Start(int interval_ms = kDefaultIntervalMs);
+    void Stop();
+    bool IsRunning() const { return sample_timer_->isActive(); }
+
+    bool StartExport(const QString &file_name, ExportFormat format);
+    void StopExport();
+    bool IsExporting() const { return export_file_.isOpen(); }
+    QString get_error_message() const { return error_message_; }
+
+signals:
+    void metricsUpdated(const MetricsMonitor::Rates &rates, const Metrics::Snapshot &totals);
+
+private slots:
+    void Sample();
+
+private:
+    void WriteExport(const Rates &rates, const Metrics::Snapshot &totals);
+
+    QTimer *sample_timer_;
+    QElapsedTimer sample_clock_;
+    Metrics::Snapshot last_snapshot_{};
+    QFile export_file_;
+    ExportFormat export_format_{ kJson };
+    QString error_message_;
+
+    static constexpr int kDefaultIntervalMs{ 1000 };
+};
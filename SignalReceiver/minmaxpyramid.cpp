@@ -0,0 +1,84 @@
+﻿#include "minmaxpyramid.h"
+#include <limits>
+
+void MinMaxPyramid::Build(const double *samples, qsizetype count)
+{
+    Clear();
+    samples_ = samples;
+    count_ = count;
+    // 第 0 层只覆盖完整的块，末尾不足一块的采样查询时直接扫描
+    QList<Range> level(count / kBaseBlock);
+    for (qsizetype block{ 0 }; block < level.size(); ++block) {
+        level[block] = ScanSamples(block * kBaseBlock, (block + 1) * kBaseBlock);
+    }
+    while (level.size() >= 2) {
+        QList<Range> upper(level.size() / 2);
+        for (qsizetype i{ 0 }; i < upper.size(); ++i) {
+            upper[i] = level[2 * i];
+            Merge(upper[i], level[2 * i + 1]);
+        }
+        levels_.append(std::move(level));
+        level = std::move(upper);
+    }
+    if (!level.isEmpty()) {
+        levels_.append(std::move(level));
+    }
+}
+
+void MinMaxPyramid::Clear()
+{
+    samples_ = nullptr;
+    count_ = 0;
+    levels_.clear();
+}
+
+MinMaxPyramid::Range MinMaxPyramid::RangeMinMax(qsizetype first, qsizetype last) const
+{
+    first = qBound<qsizetype>(0, first, count_);
+    last = qBound<qsizetype>(first, last, count_);
+    if (first == last) {
+        return Range();
+    }
+    const auto base_blocks = levels_.isEmpty() ? 0 : levels_.first().size();
+    // 区间过短或落在金字塔未覆盖的末尾时直接扫描
+    qsizetype block_first = (first + kBaseBlock - 1) / kBaseBlock;
+    const qsizetype block_last = qMin(last / kBaseBlock, base_blocks);
+    if (block_first >= block_last) {
+        return ScanSamples(first, last);
+    }
+    Range range = ScanSamples(first, block_first * kBaseBlock);
+    Merge(range, ScanSamples(block_last * kBaseBlock, last));
+    // 从左到右每次取起点对齐且不越界的最高层整块
+    while (block_first < block_last) {
+        int level{ 0 };
+        while (level + 1 < levels_.size()
+               && (block_first & ((qsizetype(2) << level) - 1)) == 0
+               && block_first + (qsizetype(2) << level) <= block_last) {
+            ++level;
+        }
+        Merge(range, levels_[level][block_first >> level]);
+        block_first += qsizetype(1) << level;
+    }
+    return range;
+}
+
+void MinMaxPyramid::Merge(Range &range, const Range &other)
+{
+    range.min = qMin(range.min, other.min);
+    range.max = qMax(range.max, other.max);
+}
+
+MinMaxPyramid::Range MinMaxPyramid::ScanSamples(qsizetype first, qsizetype last) const
+{
+    if (first >= last) {
+        // 空区间取极值的反向，合并时不影响结果
+        return Range{ std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() };
+    }
+    double low = samples_[first];
+    double high = low;
+    for (auto i{ first + 1 }; i < last; ++i) {
+        low = qMin(low, samples_[i]);
+        high = qMax(high, samples_[i]);
+    }
+    return Range{ static_cast<float>(low), static_cast<float>(high) };
+}
@@ -0,0 +1,37 @@
+﻿#pragma once
+
+#include <QtGlobal>
+#include <QList>
+
+// 多分辨率最小/最大值金字塔：第 0 层每 kBaseBlock 个采样记录一对最小/最大值，
+// 往上每层把相邻两块合并。任意区间的最小/最大值由两端不足一块的原始采样
+// 与中间 O(log n) 个整块组合得到，绘制时每个像素列的开销与总采样数无关。
+// 金字塔只引用采样，不复制，采样在下次 Build/Clear 前需保持有效
+class MinMaxPyramid
+{
+public:
+    struct Range {
+        float min{ 0.0f };
+        float max{ 0.0f };
+    };
+
+    void Build(const double *samples, qsizetype count);
+    void Clear();
+    bool isEmpty() const { return count_ == 0; }
+    qsizetype size() const { return count_; }
+    const double *samples() const { return samples_; }
+
+    // [first, last) 内采样的最小/最大值，区间为空时返回 {0, 0}
+    Range RangeMinMax(qsizetype first, qsizetype last) const;
+
+    static constexpr qsizetype kBaseBlock{ 32 };
+
+private:
+    static void Merge(Range &range, const Range &other);
+    Range ScanSamples(qsizetype first, qsizetype last) const;
+
+private:
+    const double *samples_{ nullptr };
+    qsizetype count_{ 0 };
+    QList<QList<Range>> levels_;
+};
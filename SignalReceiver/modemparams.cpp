@@ -0,0 +1,78 @@
+﻿#include "modemparams.h"
+#include <QtMath>
+#include <QRegularExpression>
+#include <cmath>
+
+QList<double> ModemParams::CarrierReference() const
+{
+    QList<double> reference(samples_per_bit);
+    for (qsizetype j{ 0 }; j < samples_per_bit; ++j) {
+        const double t = static_cast<double>(j) / sample_rate;
+        reference[j] = sin(2 * M_PI * carrier_freq * t);
+    }
+    return reference;
+}
+
+bool ModemParams::Validate(QString *error_message) const
+{
+    QString error;
+    if (!(sample_rate > 0.0) || !std::isfinite(sample_rate)) {
+        error = QString("采样率无效: %1 Hz").arg(sample_rate);
+    } else if (samples_per_bit < kMinSamplesPerBit || samples_per_bit > kMaxSamplesPerBit) {
+        error = QString("每比特采样数无效: %1（允许 %2 ~ %3）")
+                .arg(samples_per_bit).arg(kMinSamplesPerBit).arg(kMaxSamplesPerBit);
+    } else if (!(carrier_freq > 0.0) || carrier_freq >= sample_rate / 2) {
+        error = QString("载波频率无效: %1 Hz（需低于采样率的一半）").arg(carrier_freq);
+    } else if (preamble.size() > kMaxPreambleBytes) {
+        error = QString("前导码过长: %1 字节（最多 %2 字节）").arg(preamble.size()).arg(kMaxPreambleBytes);
+    }
+    if (error.isEmpty()) {
+        return true;
+    }
+    if (error_message) {
+        *error_message = error;
+    }
+    return false;
+}
+
+QString ModemParams::Describe() const
+{
+    auto text = QString("采样率 %1 Hz, 每比特 %2 点, 载波 %3 Hz, 传信率 %4 bps")
+        .arg(sample_rate)
+        .arg(samples_per_bit)
+        .arg(carrier_freq)
+        .arg(BitRate());
+    if (symbol_sync) {
+        text += preamble.isEmpty() ? ", 同步解调" : ", 同步解调, 前导码 " + PreambleText();
+    }
+    return text;
+}
+
+QString ModemParams::PreambleText() const
+{
+    return QString::fromLatin1(preamble.toHex(' ').toUpper());
+}
+
+ModemParams ModemParams::FromHeader(const SampleContainer::Header &header, const ModemParams &base)
+{
+    ModemParams params = base;
+    params.sample_rate = header.sample_rate;
+    params.samples_per_bit = static_cast<qsizetype>(header.samples_per_bit);
+    params.carrier_freq = header.carrier_freq;
+    return params;
+}
+
+bool ModemParams::ParsePreamble(const QString &text, QByteArray &preamble, QString *error_message)
+{
+    QString digits = text;
+    digits.remove(QRegularExpression("\\s"));
+    static const QRegularExpression hex_pattern("^([0-9A-Fa-f]{2})*$");
+    if (!hex_pattern.match(digits).hasMatch()) {
+        if (error_message) {
+            *error_message = QString("前导码须为成对的十六进制数字: %1").arg(text);
+        }
+        return false;
+    }
+    preamble = QByteArray::fromHex(digits.toLatin1());
+    return true;
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include <QtGlobal>
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include "samplecontainer.h"
+
+// 调制参数：默认值为发送端的标准配置，也可由界面设置或从二进制采样容器头读取。
+// 每比特 8/16/32 个采样时解调内核使用编译期展开的专用版本，其余取值走通用循环
+struct ModemParams {
+    double sample_rate{ 1600.0 };
+    qsizetype samples_per_bit{ 16 };
+    double carrier_freq{ 200.0 };
+    // 同步解调（载波与位定时恢复）及其前导码，前导码按高位在前的字节给出，为空时不搜索前导码
+    bool symbol_sync{ false };
+    QByteArray preamble;
+
+    double BitRate() const { return sample_rate / samples_per_bit; }
+    // ASK 能量判决阈值，与每比特采样数成正比
+    double AskThreshold() const { return 0.05 * samples_per_bit; }
+    // 一个比特周期的载波参考信号 sin(2*pi*fc*t)
+    QList<double> CarrierReference() const;
+    // 采样率与载波需为正数，载波低于奈奎斯特频率，每比特采样数在允许范围内
+    bool Validate(QString *error_message = nullptr) const;
+    QString Describe() const;
+    // 前导码的十六进制表示，每字节以空格分隔
+    QString PreambleText() const;
+
+    // 采样率、每比特采样数与载波取自容器头，其余设置沿用 base
+    static ModemParams FromHeader(const SampleContainer::Header &header, const ModemParams &base);
+    // 解析十六进制前导码，允许空白分隔
+    static bool ParsePreamble(const QString &text, QByteArray &preamble, QString *error_message = nullptr);
+
+    bool operator==(const ModemParams &other) const
+    {
+        return sample_rate == other.sample_rate && samples_per_bit == other.samples_per_bit
+               && carrier_freq == other.carrier_freq && symbol_sync == other.symbol_sync
+               && preamble == other.preamble;
+    }
+    bool operator!=(const ModemParams &other) const { return !(*this == other); }
+
+    static constexpr qsizetype kMinSamplesPerBit{ 2 };
+    static constexpr qsizetype kMaxSamplesPerBit{ 4096 };
+    static constexpr qsizetype kMaxPreambleBytes{ 64 };
+};
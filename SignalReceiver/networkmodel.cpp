@@ -1,69 +1,66 @@
 ﻿#include "networkmodel.h"
 #include <QDir>
-#include <QFileInfo>
-#include <QDataStream>
 
 
 NetworkModel::NetworkModel(QObject *parent)
     : QObject(parent)
     , socket_(new QTcpSocket(this))
-    , receive_directory_(QDir::currentPath())
-    , receive_state_(kNotReceiving)
-    , expected_file_size_(0)
-    , bytes_received_(0)
-    , receive_file_(nullptr)
+    , connect_timer_(new QTimer(this))
+    , retry_timer_(new QTimer(this))
+    , receive_session_(new ReceiveSession(socket_, this))
+    , stream_demodulator_(new StreamDemodulator(this))
 {
+    receive_session_->set_stream_demodulator(stream_demodulator_);
+    connect_timer_->setSingleShot(true);
+    retry_timer_->setSingleShot(true);
+    connect(connect_timer_, &QTimer::timeout, this, &NetworkModel::onConnectTimeout);
+    connect(retry_timer_, &QTimer::timeout, this, &NetworkModel::BeginConnectAttempt);
+    connect(socket_, &QTcpSocket::connected, this, &NetworkModel::onConnected);
     connect(socket_, &QTcpSocket::errorOccurred, this, &NetworkModel::onErrorOccurred);
-    connect(socket_, &QTcpSocket::readyRead, this, &NetworkModel::onReadyRead);
+    connect(receive_session_, &ReceiveSession::fileReceiveStarted, this, &NetworkModel::fileReceiveStarted);
+    connect(receive_session_, &ReceiveSession::fileReceiveCompleted, this, &NetworkModel::fileReceiveCompleted);
+    connect(receive_session_, &ReceiveSession::fileReceiveError, this, &NetworkModel::fileReceiveError);
+    connect(receive_session_, &ReceiveSession::protocolError, this, &NetworkModel::onProtocolError);
 }
 
 NetworkModel::~NetworkModel()
 {
-    if (receive_file_) {
-        receive_file_->close();
-        delete receive_file_;
-        receive_file_ = nullptr;
-    }
 }
 
 void NetworkModel::StartConnection(const QString &ip, const QString &port)
 {
     // 清除旧的错误信息
-    error_message_.clear();
+    SetErrorMessage(QString());
     // 验证IP和端口
     if (!IsValidIPv4(ip)) {
-        error_message_ = "无效的IPv4地址格式";
-        emit connectionChanged(Error);
+        SetErrorMessage("无效的IPv4地址格式");
+        SetConnectionState(Error);
         return;
     }
     quint16 port_num{ 0 };
     if (!IsValidPort(port, port_num)) {
-        error_message_ = "无效的端口号(1-65535)";
-        emit connectionChanged(Error);
+        SetErrorMessage("无效的端口号(1-65535)");
+        SetConnectionState(Error);
         return;
     }
-    // 如果已连接，先断开
-    if (socket_->state() == QAbstractSocket::ConnectedState || socket_->state() == QAbstractSocket::ConnectingState) {
-        socket_->abort();
-    }
-    // 告知UI正在连接中
-    emit connectionChanged(Connecting);
-    // 开始同步连接
-    socket_->connectToHost(ip, port_num);
-    if (socket_->waitForConnected(5000)) { // 5秒超时
-        emit connectionChanged(Connected);
-    } else {
-        error_message_ = socket_->errorString();
-        if (error_message_.isEmpty() && socket_->state() != QAbstractSocket::ConnectedState) {
-            error_message_ = "连接超时或发生未知错误";
-        }
+    // 如果已连接或正在重试，先中止
+    connect_timer_->stop();
+    retry_timer_->stop();
+    if (socket_->state() != QAbstractSocket::UnconnectedState) {
         socket_->abort();
-        emit connectionChanged(Error);
     }
+    target_ip_ = ip;
+    target_port_ = port_num;
+    connect_attempt_ = 0;
+    // 告知UI正在连接中，连接结果由 connected/errorOccurred 信号或超时定时器异步给出
+    SetConnectionState(Connecting);
+    BeginConnectAttempt();
 }
 
 void NetworkModel::CloseConnection()
 {
+    connect_timer_->stop();
+    retry_timer_->stop();
     if (socket_->state() == QAbstractSocket::ConnectedState || socket_->state() == QAbstractSocket::ConnectingState) {
         socket_->disconnectFromHost();
         if (socket_->state() != QAbstractSocket::UnconnectedState) {
@@ -71,105 +68,105 @@ void NetworkModel::CloseConnection()
         }
     }
     ResetReceiveState();
-    emit connectionChanged(Disconnected);
+    SetConnectionState(Disconnected);
 }
 
 void NetworkModel::set_receive_directory(const QString &directory_path)
 {
-    if (QDir(directory_path).exists()) {
-        receive_directory_ = directory_path;
-    }
+    receive_session_->set_receive_directory(directory_path);
+}
+
+void NetworkModel::set_stream_demodulation(bool enabled, const QString &demodulate_t, const QString &decode_t,
+                                           const ModemParams &params)
+{
+    receive_session_->set_stream_demodulation(enabled, demodulate_t, decode_t, params);
+}
+
+void NetworkModel::onConnected()
+{
+    connect_timer_->stop();
+    connect_attempt_ = 0;
+    // 加大内核接收缓冲，高速链路上减少窗口收缩
+    socket_->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 4 * 1024 * 1024);
+    SetConnectionState(Connected);
+}
+
+void NetworkModel::onConnectTimeout()
+{
+    socket_->abort();
+    HandleConnectFailure("连接超时");
 }
 
 void NetworkModel::onErrorOccurred(QAbstractSocket::SocketError socketError)
 {
-    if (socket_->state() != QAbstractSocket::ConnectedState) {
-        if (error_message_.isEmpty()) {
-            error_message_ = socket_->errorString();
-        }
-    } else {
-        error_message_ = socket_->errorString();
+    // 连接阶段的错误交给重试逻辑处理
+    if (connection_state_ == Connecting) {
+        connect_timer_->stop();
+        const auto reason = socket_->errorString();
+        socket_->abort();
+        HandleConnectFailure(reason);
+        return;
     }
+    const auto reason = socket_->errorString();
+    // 传输中断且有可续传的文件时自动重连，重连后由发送端按续传偏移继续
+    if (receive_session_->HasResumableFiles()) {
+        ResetReceiveState();
+        ReconnectForResume(reason);
+        return;
+    }
+    SetErrorMessage(reason);
     ResetReceiveState();
-    emit connectionChanged(Error);
+    SetConnectionState(Error);
 }
 
-void NetworkModel::onReadyRead()
+void NetworkModel::BeginConnectAttempt()
 {
-    if (socket_->state() == QAbstractSocket::ConnectedState) {
-        ProcessIncomingData();
-    }
+    socket_->connectToHost(target_ip_, target_port_);
+    connect_timer_->start(connect_timeout_ms_);
 }
 
-void NetworkModel::ProcessIncomingData()
+void NetworkModel::HandleConnectFailure(const QString &reason)
 {
-    QByteArray data = socket_->readAll();
-    receive_buffer_.append(data);
-    if (receive_state_ == kNotReceiving) {
-        // 尝试解析文件头信息
-        QDataStream stream(receive_buffer_);
-        stream.setVersion(QDataStream::Qt_6_0);
-        QString file_name;
-        qint64 file_size;
-        // 尝试读取文件名和文件大小
-        stream >> file_name >> file_size;
-        if (stream.status() == QDataStream::Ok && !file_name.isEmpty() && file_size > 0) {
-            // 成功解析头部信息
-            expected_file_name_ = file_name;
-            expected_file_size_ = file_size;
-            // 计算头部大小并移除
-            qint64 header_size = stream.device()->pos();
-            receive_buffer_.remove(0, header_size);
-            // 准备接收文件
-            QString save_path = QDir(receive_directory_).filePath(QFileInfo(expected_file_name_).fileName());
-            receive_file_ = new QFile(save_path, this);
-            if (!receive_file_->open(QIODevice::WriteOnly)) {
-                emit fileReceiveError("无法创建文件: " + save_path);
-                ResetReceiveState();
-                return;
-            }
-            receive_state_ = kReceiving;
-            bytes_received_ = 0;
-            emit fileReceiveStarted(expected_file_name_, expected_file_size_);
-        }
+    const int max_retries = max_connect_retries_;
+    if (connect_attempt_ < max_retries) {
+        // 指数退避，单次等待不超过 30 秒；移位在 64 位中进行，避免初始间隔较大时溢出
+        const int delay_ms = static_cast<int>(qMin<qint64>(qint64(initial_backoff_ms_) << qMin(connect_attempt_, 16), 30000));
+        ++connect_attempt_;
+        emit connectionRetrying(connect_attempt_, max_retries, delay_ms, reason);
+        retry_timer_->start(delay_ms);
+        return;
     }
-    if (receive_state_ == kReceiving && !receive_buffer_.isEmpty()) {
-        // 写入文件数据
-        qint64 bytes_to_write = qMin(static_cast<qint64>(receive_buffer_.size()), 
-                                    expected_file_size_ - bytes_received_);
-        if (bytes_to_write > 0) {
-            qint64 bytes_written = receive_file_->write(receive_buffer_.left(bytes_to_write));
-            if (bytes_written == -1) {
-                emit fileReceiveError("写入文件失败: " + receive_file_->errorString());
-                ResetReceiveState();
-                return;
-            }
-            bytes_received_ += bytes_written;
-            receive_buffer_.remove(0, bytes_written);
-            emit fileReceiveProgress(bytes_received_, expected_file_size_);
-            // 检查是否接收完成
-            if (bytes_received_ >= expected_file_size_) {
-                QString saved_path = receive_file_->fileName();
-                receive_file_->close();
-                delete receive_file_;
-                receive_file_ = nullptr;
-                emit fileReceiveCompleted(saved_path);
-                receive_state_ = kNotReceiving;
-            }
-        }
+    SetErrorMessage(reason.isEmpty() ? QString("连接超时或发生未知错误") : reason);
+    SetConnectionState(Error);
+}
+
+void NetworkModel::SetConnectionState(ConnectionState state)
+{
+    connection_state_ = state;
+    emit connectionChanged(state);
+}
+
+void NetworkModel::onProtocolError(const QString &error_message, bool can_resume)
+{
+    // 数据流失去同步，断开连接，由发送端重新建立会话
+    socket_->abort();
+    if (can_resume) {
+        ReconnectForResume(error_message);
+        return;
     }
+    SetErrorMessage(error_message);
+    SetConnectionState(Error);
+}
+
+void NetworkModel::ReconnectForResume(const QString &reason)
+{
+    socket_->abort();
+    connect_attempt_ = 0;
+    SetConnectionState(Connecting);
+    HandleConnectFailure(reason);
 }
 
 void NetworkModel::ResetReceiveState()
 {
-    if (receive_file_) {
-        receive_file_->close();
-        delete receive_file_;
-        receive_file_ = nullptr;
-    }
-    receive_state_ = kNotReceiving;
-    expected_file_name_.clear();
-    expected_file_size_ = 0;
-    bytes_received_ = 0;
-    receive_buffer_.clear();
+    receive_session_->Reset();
 }
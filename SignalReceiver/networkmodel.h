@@ -3,8 +3,10 @@
 #include <QObject>
 #include <QTcpSocket>
 #include <QHostAddress>
-#include <QFile>
-#include <QDataStream>
+#include <QTimer>
+#include <QMutex>
+#include <atomic>
+#include "receivesession.h"
 
 class NetworkModel : public QObject
 {
@@ -24,6 +26,8 @@ public:
     };
 
 public:
+    // 模型运行在独立的接收线程中：StartConnection/CloseConnection 需通过
+    // QMetaObject::invokeMethod 在该线程调用，其余 get/set 接口可在任意线程调用
     NetworkModel(QObject *parent);
     ~NetworkModel();
 
@@ -31,39 +35,65 @@ public:
     void CloseConnection();
 
     void set_receive_directory(const QString &directory_path);
+    void set_stream_demodulation(bool enabled, const QString &demodulate_t, const QString &decode_t,
+                                 const ModemParams &params = ModemParams());
+    // 单次连接超时与失败后的重试策略（指数退避）
+    void set_connect_timeout(int timeout_ms) { connect_timeout_ms_ = timeout_ms; }
+    void set_connect_retry_policy(int max_retries, int initial_backoff_ms) { max_connect_retries_ = max_retries; initial_backoff_ms_ = initial_backoff_ms; }
 
-    bool IsConnected() const { return socket_->state() == QAbstractSocket::ConnectedState; }
-    QString get_error_message() const { return error_message_.isEmpty() ? socket_->errorString() : error_message_; }
-    ReceiveState get_receive_state() const { return receive_state_; }
-    QString get_receive_directory() const { return receive_directory_; }
+    bool IsConnected() const { return connection_state_ == Connected; }
+    QString get_error_message() const { QMutexLocker locker(&settings_mutex_); return error_message_; }
+    ConnectionState get_connection_state() const { return connection_state_; }
+    ReceiveState get_receive_state() const { return receive_session_->IsReceiving() ? kReceiving : kNotReceiving; }
+    QString get_receive_directory() const { return receive_session_->get_receive_directory(); }
+    StreamDemodulator *get_stream_demodulator() const { return stream_demodulator_; }
+    std::shared_ptr<const ReceiveSession::Counters> get_receive_counters() const { return receive_session_->get_counters(); }
 
 signals:
     void connectionChanged(ConnectionState state);
+    void connectionRetrying(int attempt, int max_retries, int delay_ms, const QString &reason);
     void fileReceiveStarted(const QString &file_name, qint64 file_size);
-    void fileReceiveProgress(qint64 bytes_received, qint64 total_bytes);
     void fileReceiveCompleted(const QString &saved_file_path);
     void fileReceiveError(const QString &error_message);
 
 private slots:
+    void onConnected();
+    void onConnectTimeout();
     void onErrorOccurred(QAbstractSocket::SocketError error);
-    void onReadyRead();
+    void onProtocolError(const QString &error_message, bool can_resume);
 
 private:
     bool IsValidIPv4(const QString &ip) const { QHostAddress address(ip); return !address.isNull() && address.protocol() == QAbstractSocket::IPv4Protocol; }
     bool IsValidPort(const QString &port, quint16 &port_num) const { bool ok{ false }; auto value = port.toUShort(&ok); if (ok && value > 0 && value <= 65535) { port_num = static_cast<quint16>(value); return true; } return false; }
-    void ProcessIncomingData();
+    void BeginConnectAttempt();
+    void HandleConnectFailure(const QString &reason);
+    void ReconnectForResume(const QString &reason);
+    void SetConnectionState(ConnectionState state);
+    void SetErrorMessage(const QString &error_message) { QMutexLocker locker(&settings_mutex_); error_message_ = error_message; }
     void ResetReceiveState();
 
 private:
+    // 保护可被 UI 线程读取的错误信息
+    mutable QMutex settings_mutex_;
+
     QTcpSocket *socket_;
     QString error_message_;
-    QString receive_directory_;
-    ReceiveState receive_state_;
-
-    // 文件接收相关
-    QString expected_file_name_;
-    qint64 expected_file_size_;
-    qint64 bytes_received_;
-    QFile *receive_file_;
-    QByteArray receive_buffer_;
+    std::atomic<ConnectionState> connection_state_{ Disconnected };
+
+    // 异步连接相关
+    QTimer *connect_timer_;
+    QTimer *retry_timer_;
+    QString target_ip_;
+    quint16 target_port_{ 0 };
+    // 重试策略可由其他线程设置，在接收线程中读取
+    std::atomic<int> connect_timeout_ms_{ 5000 };
+    std::atomic<int> max_connect_retries_{ 3 };
+    std::atomic<int> initial_backoff_ms_{ 500 };
+    int connect_attempt_{ 0 };
+
+    // 文件接收由会话完成，客户端模式下整个连接对应一个会话
+    ReceiveSession *receive_session_;
+
+    // 流式解调相关
+    StreamDemodulator *stream_demodulator_;
 };
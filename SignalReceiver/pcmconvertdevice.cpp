@@ -0,0 +1,156 @@
+﻿#include "pcmconvertdevice.h"
+#include <cstring>
+
+PcmConvertDevice::PcmConvertDevice(QObject *parent)
+    : QIODevice(parent)
+{}
+
+PcmConvertDevice::~PcmConvertDevice()
+{
+    close();
+}
+
+bool PcmConvertDevice::Open(QIODevice *source, const WavFile::Info &info, const QAudioFormat &output_format)
+{
+    close();
+    if (!source || !source->isOpen() || info.block_align <= 0 || info.sample_rate <= 0
+        || output_format.sampleRate() <= 0 || output_format.channelCount() <= 0
+        || EncodingFor(output_format.sampleFormat()) == WavFile::Encoding::kUnknown) {
+        return false;
+    }
+    source_ = source;
+    info_ = info;
+    output_format_ = output_format;
+    output_encoding_ = EncodingFor(output_format.sampleFormat());
+    // 输出长度按帧数比例估算，重采样的尾部可能少于一帧
+    const qint64 output_frames = static_cast<qint64>(
+        static_cast<double>(info.FrameCount()) * output_format.sampleRate() / info.sample_rate);
+    output_size_ = output_frames * output_format.bytesPerFrame();
+    resampler_.Reset(output_format.channelCount(), info.sample_rate, output_format.sampleRate());
+    raw_.resize(kChunkFrames * info.block_align);
+    decoded_.resize(kChunkFrames * info.channel_count);
+    mixed_.resize(kChunkFrames * output_format.channelCount());
+    output_.clear();
+    output_pos_ = 0;
+    source_exhausted_ = false;
+    return QIODevice::open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+void PcmConvertDevice::close()
+{
+    source_ = nullptr;
+    output_size_ = 0;
+    output_.clear();
+    output_pos_ = 0;
+    if (isOpen()) {
+        QIODevice::close();
+    }
+}
+
+bool PcmConvertDevice::seek(qint64 pos)
+{
+    if (!source_ || pos < 0 || pos > output_size_) {
+        return false;
+    }
+    // 对齐到输出帧后换算源帧位置
+    const int bytes_per_frame = output_format_.bytesPerFrame();
+    const qint64 output_frame = pos / bytes_per_frame;
+    const qint64 source_frame = static_cast<qint64>(
+        static_cast<double>(output_frame) * info_.sample_rate / output_format_.sampleRate());
+    if (!source_->seek(qMin(source_frame, info_.FrameCount()) * info_.block_align)
+        || !QIODevice::seek(output_frame * bytes_per_frame)) {
+        return false;
+    }
+    resampler_.Reset(output_format_.channelCount(), info_.sample_rate, output_format_.sampleRate());
+    output_.clear();
+    output_pos_ = 0;
+    source_exhausted_ = false;
+    return true;
+}
+
+QAudioFormat::SampleFormat PcmConvertDevice::SampleFormatFor(WavFile::Encoding encoding)
+{
+    switch (encoding) {
+    case WavFile::Encoding::kUInt8:
+        return QAudioFormat::UInt8;
+    case WavFile::Encoding::kInt16:
+        return QAudioFormat::Int16;
+    case WavFile::Encoding::kInt32:
+        return QAudioFormat::Int32;
+    case WavFile::Encoding::kFloat32:
+        return QAudioFormat::Float;
+    default:
+        break;
+    }
+    return QAudioFormat::Unknown;
+}
+
+WavFile::Encoding PcmConvertDevice::EncodingFor(QAudioFormat::SampleFormat format)
+{
+    switch (format) {
+    case QAudioFormat::UInt8:
+        return WavFile::Encoding::kUInt8;
+    case QAudioFormat::Int16:
+        return WavFile::Encoding::kInt16;
+    case QAudioFormat::Int32:
+        return WavFile::Encoding::kInt32;
+    case QAudioFormat::Float:
+        return WavFile::Encoding::kFloat32;
+    default:
+        break;
+    }
+    return WavFile::Encoding::kUnknown;
+}
+
+qint64 PcmConvertDevice::readData(char *data, qint64 max_size)
+{
+    qint64 copied{ 0 };
+    while (copied < max_size) {
+        if (output_pos_ >= output_.size() && !ConvertNextChunk()) {
+            break;
+        }
+        const qint64 count = qMin<qint64>(max_size - copied, output_.size() - output_pos_);
+        memcpy(data + copied, output_.constData() + output_pos_, count);
+        copied += count;
+        output_pos_ += count;
+    }
+    return copied;
+}
+
+qint64 PcmConvertDevice::writeData(const char *data, qint64 max_size)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(max_size);
+    return -1;
+}
+
+bool PcmConvertDevice::ConvertNextChunk()
+{
+    const int output_channels = output_format_.channelCount();
+    // 降采样时一块可能不产生输出，继续读取下一块；源数据读完或读取出错时返回 false
+    qint64 output_frames{ 0 };
+    while (output_frames <= 0) {
+        const qint64 read = source_ ? source_->read(raw_.data(), raw_.size()) : -1;
+        const qint64 frames = read > 0 ? read / info_.block_align : 0;
+        if (frames <= 0) {
+            source_exhausted_ = true;
+            return false;
+        }
+        SampleConvert::Decode(raw_.constData(), info_.encoding, frames * info_.channel_count, decoded_.data());
+        const float *samples = decoded_.constData();
+        if (info_.channel_count != output_channels) {
+            SampleConvert::MixChannels(samples, info_.channel_count, frames, mixed_.data(), output_channels);
+            samples = mixed_.constData();
+        }
+        output_frames = frames;
+        if (!resampler_.IsPassthrough()) {
+            resampled_.clear();
+            output_frames = resampler_.Process(samples, frames, resampled_);
+            samples = resampled_.constData();
+        }
+        output_.resize(output_frames * output_format_.bytesPerFrame());
+        SampleConvert::Encode(samples, output_encoding_, output_frames * output_channels, output_.data());
+    }
+    output_pos_ = 0;
+    return true;
+}
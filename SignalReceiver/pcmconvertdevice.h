@@ -0,0 +1,59 @@
+﻿#pragma once
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QList>
+#include <QAudioFormat>
+#include "wavfile.h"
+#include "sampleconvert.h"
+
+// 格式转换设备：从源设备读取 WAV 原始数据，按块完成采样格式、声道与采样率转换后
+// 输出为设备可播放的格式。供输出设备不支持文件原始格式时在 QAudioSink 与流式读取设备之间使用。
+// 定位按输出帧换算到源帧，并重置重采样状态
+class PcmConvertDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    PcmConvertDevice(QObject *parent);
+    ~PcmConvertDevice();
+
+    // source 须已打开且位于数据区起点，info 描述其数据格式
+    bool Open(QIODevice *source, const WavFile::Info &info, const QAudioFormat &output_format);
+    void close() override;
+
+    bool isSequential() const override { return false; }
+    qint64 size() const override { return output_size_; }
+    // size() 按比例估算，结束以源数据读完且输出缓冲取尽为准
+    bool atEnd() const override { return source_exhausted_ && output_pos_ >= output_.size(); }
+    bool seek(qint64 pos) override;
+
+    // QAudioFormat 采样格式与 WAV 编码的对应；24 位整数与 64 位浮点没有对应的 QAudioFormat 格式
+    static QAudioFormat::SampleFormat SampleFormatFor(WavFile::Encoding encoding);
+    static WavFile::Encoding EncodingFor(QAudioFormat::SampleFormat format);
+
+protected:
+    qint64 readData(char *data, qint64 max_size) override;
+    qint64 writeData(const char *data, qint64 max_size) override;
+
+private:
+    bool ConvertNextChunk();
+
+private:
+    QIODevice *source_{ nullptr };
+    WavFile::Info info_;
+    QAudioFormat output_format_;
+    WavFile::Encoding output_encoding_{ WavFile::Encoding::kUnknown };
+    qint64 output_size_{ 0 };
+    SampleConvert::Resampler resampler_;
+    // 各阶段缓冲，按块复用
+    QByteArray raw_;
+    QList<float> decoded_;
+    QList<float> mixed_;
+    QList<float> resampled_;
+    QByteArray output_;
+    qsizetype output_pos_{ 0 };
+    bool source_exhausted_{ false };
+
+    static constexpr qint64 kChunkFrames{ 8192 };
+};
@@ -0,0 +1,85 @@
+﻿#include "progressreporter.h"
+
+
+ProgressReporter::ProgressReporter(QObject *parent)
+    : QObject(parent)
+    , sample_timer_(new QTimer(this))
+{
+    connect(sample_timer_, &QTimer::timeout, this, &ProgressReporter::Sample);
+}
+
+void ProgressReporter::Start(int interval_ms)
+{
+    if (!counters_) {
+        return;
+    }
+    last_bytes_ = counters_->bytes_received;
+    smoothed_rate_ = 0.0;
+    last_active_ = false;
+    last_files_completed_ = counters_->files_completed;
+    sample_clock_.start();
+    sample_timer_->start(interval_ms);
+}
+
+void ProgressReporter::Stop()
+{
+    sample_timer_->stop();
+}
+
+QString ProgressReporter::FormatSnapshot(const Snapshot &snapshot)
+{
+    if (snapshot.completed) {
+        return "接收完成";
+    }
+    if (!snapshot.active) {
+        return "空闲";
+    }
+    QString eta("--:--");
+    if (snapshot.eta_ms >= 0) {
+        const qint64 seconds = (snapshot.eta_ms + 999) / 1000;
+        eta = QString("%1:%2").arg(seconds / 60, 2, 10, QChar('0')).arg(seconds % 60, 2, 10, QChar('0'));
+    }
+    return QString("%1 / %2 MB    %3 MB/s    剩余 %4")
+        .arg(snapshot.bytes_received / (1024.0 * 1024.0), 0, 'f', 1)
+        .arg(snapshot.bytes_total / (1024.0 * 1024.0), 0, 'f', 1)
+        .arg(snapshot.bytes_per_second / (1024.0 * 1024.0), 0, 'f', 2)
+        .arg(eta);
+}
+
+void ProgressReporter::Sample()
+{
+    const double elapsed_seconds = sample_clock_.restart() / 1000.0;
+    const qint64 bytes = counters_->bytes_received;
+    const double rate = elapsed_seconds > 0.0 ? (bytes - last_bytes_) / elapsed_seconds : 0.0;
+    last_bytes_ = bytes;
+    smoothed_rate_ = smoothed_rate_ > 0.0 ? kRateSmoothing * rate + (1.0 - kRateSmoothing) * smoothed_rate_ : rate;
+
+    Snapshot snapshot;
+    snapshot.bytes_received = counters_->active_bytes_received;
+    snapshot.bytes_total = counters_->active_bytes_total;
+    snapshot.active = snapshot.bytes_total > 0;
+    // 文件完成后活动字节数立即归零，单独记录完成事件，
+    // 否则两次采样之间收完的小文件永远不会显示进度
+    const int files_completed = counters_->files_completed;
+    const bool file_completed = files_completed != last_files_completed_;
+    last_files_completed_ = files_completed;
+    // 空闲时只在状态切换或有文件完成时更新一次
+    if (!snapshot.active && !last_active_ && !file_completed) {
+        return;
+    }
+    last_active_ = snapshot.active;
+    if (snapshot.active) {
+        snapshot.percent = static_cast<int>(qBound<qint64>(0, snapshot.bytes_received * 100 / snapshot.bytes_total, 100));
+        snapshot.bytes_per_second = smoothed_rate_;
+        if (smoothed_rate_ > 0.0) {
+            snapshot.eta_ms = static_cast<qint64>((snapshot.bytes_total - snapshot.bytes_received) * 1000.0 / smoothed_rate_);
+        }
+    } else {
+        if (file_completed) {
+            snapshot.completed = true;
+            snapshot.percent = 100;
+        }
+        smoothed_rate_ = 0.0;
+    }
+    emit progressUpdated(snapshot);
+}
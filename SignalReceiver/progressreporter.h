@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <memory>
+#include "receivesession.h"
+
+// 进度采样器：在 UI 线程中按固定频率读取接收会话的原子计数，
+// 计算平滑吞吐率与剩余时间后发出一次更新。无论数据到达多快，UI 开销只与采样频率有关
+class ProgressReporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Snapshot {
+        bool active{ false };           // 是否有未完成的文件
+        bool completed{ false };        // 空闲前刚有文件接收完成，进度停留在 100%
+        qint64 bytes_received{ 0 };
+        qint64 bytes_total{ 0 };
+        int percent{ 0 };
+        double bytes_per_second{ 0.0 };
+        qint64 eta_ms{ -1 };            // 吞吐率未知时为 -1
+    };
+
+    ProgressReporter(QObject *parent);
+
+    void set_counters(std::shared_ptr<const ReceiveSession::Counters> counters) { counters_ = std::move(counters); }
+    void Start(int interval_ms = kDefaultIntervalMs);
+    void Stop();
+
+    static QString FormatSnapshot(const Snapshot &snapshot);
+
+signals:
+    void progressUpdated(const ProgressReporter::Snapshot &snapshot);
+
+private slots:
+    void Sample();
+
+private:
+    std::shared_ptr<const ReceiveSession::Counters> counters_;
+    QTimer *sample_timer_;
+    QElapsedTimer sample_clock_;
+    qint64 last_bytes_{ 0 };
+    double smoothed_rate_{ 0.0 };
+    bool last_active_{ false };
+    int last_files_completed_{ 0 };
+
+    static constexpr int kDefaultIntervalMs{ 250 };
+    // 吞吐率指数滑动平均的权重
+    static constexpr double kRateSmoothing{ 0.3 };
+};
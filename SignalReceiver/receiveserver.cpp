@@ -0,0 +1,259 @@
+﻿#include "receiveserver.h"
+#include <QDir>
+#include <QHostAddress>
+
+
+ReceiveConnection::ReceiveConnection(quint64 connection_id, const QString &receive_directory, QObject *worker_host)
+    : QObject(nullptr)
+    , connection_id_(connection_id)
+    , receive_directory_(receive_directory)
+    , worker_host_(worker_host)
+    , socket_(new QTcpSocket(this))
+    , receive_session_(new ReceiveSession(socket_, this))
+{
+    connect(socket_, &QTcpSocket::disconnected, this, &ReceiveConnection::onDisconnected);
+    connect(receive_session_, &ReceiveSession::protocolError, this, &ReceiveConnection::onProtocolError);
+    connect(receive_session_, &ReceiveSession::fileReceiveCompleted, this, [this](const QString &saved_file_path) {
+        emit fileReceiveCompleted(peer_, saved_file_path);
+    });
+    connect(receive_session_, &ReceiveSession::fileReceiveError, this, [this](const QString &error_message) {
+        emit fileReceiveError(peer_, error_message);
+    });
+}
+
+ReceiveConnection::~ReceiveConnection()
+{
+    emit closed(connection_id_);
+}
+
+void ReceiveConnection::Open(qintptr socket_descriptor)
+{
+    // 挂到工作线程的宿主下，服务器停止时由宿主在本线程统一销毁
+    setParent(worker_host_);
+    if (!socket_->setSocketDescriptor(socket_descriptor)) {
+        emit fileReceiveError(QString(), "无法接管连接: " + socket_->errorString());
+        deleteLater();
+        return;
+    }
+    socket_->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, kSocketReceiveBufferSize);
+    peer_ = QString("%1:%2").arg(socket_->peerAddress().toString()).arg(socket_->peerPort());
+    // 各发送端的文件保存在以其地址命名的子目录中，避免同名文件互相覆盖
+    const auto directory_path = QDir(receive_directory_).filePath(socket_->peerAddress().toString());
+    QDir().mkpath(directory_path);
+    receive_session_->set_receive_directory(directory_path);
+    emit opened(connection_id_, peer_);
+    // 描述符接管前已到达的数据不会触发 readyRead
+    receive_session_->ProcessIncomingData();
+}
+
+void ReceiveConnection::onDisconnected()
+{
+    receive_session_->Reset();
+    deleteLater();
+}
+
+void ReceiveConnection::onProtocolError(const QString &error_message)
+{
+    emit fileReceiveError(peer_, error_message);
+    socket_->abort();
+    deleteLater();
+}
+
+ReceiveServer::ReceiveServer(QObject *parent)
+    : QTcpServer(parent)
+    , receive_directory_(QDir::currentPath())
+    , stats_timer_(new QTimer(this))
+{
+    // 大量发送端可能同时发起连接，默认的等待队列长度不足
+    setMaxPendingConnections(kMaxPendingConnections);
+    setListenBacklogSize(kMaxPendingConnections);
+    connect(stats_timer_, &QTimer::timeout, this, &ReceiveServer::UpdateStats);
+}
+
+ReceiveServer::~ReceiveServer()
+{
+    Stop();
+}
+
+bool ReceiveServer::Start(const QString &ip, const QString &port)
+{
+    Stop();
+    SetErrorMessage(QString());
+    // 地址留空时监听所有网卡
+    QHostAddress address(QHostAddress::Any);
+    if (!ip.isEmpty()) {
+        address = QHostAddress(ip);
+        if (address.isNull() || address.protocol() != QAbstractSocket::IPv4Protocol) {
+            SetErrorMessage("无效的IPv4地址格式");
+            emit listeningChanged(false);
+            return false;
+        }
+    }
+    bool ok{ false };
+    const auto port_num = port.toUShort(&ok);
+    if (!ok || port_num == 0) {
+        SetErrorMessage("无效的端口号(1-65535)");
+        emit listeningChanged(false);
+        return false;
+    }
+    // 工作线程数默认与 CPU 核数相同，连接按当前负载分配
+    const int worker_count = worker_count_ > 0 ? worker_count_ : qMax(1, QThread::idealThreadCount());
+    for (int i{ 0 }; i < worker_count; ++i) {
+        auto thread = new QThread(this);
+        thread->setObjectName(QString("ReceiveWorker%1").arg(i));
+        auto host = new QObject;
+        host->moveToThread(thread);
+        thread->start();
+        worker_threads_.append(thread);
+        worker_hosts_.append(host);
+        worker_loads_.append(0);
+    }
+    if (!listen(address, port_num)) {
+        SetErrorMessage(errorString());
+        Stop();
+        emit listeningChanged(false);
+        return false;
+    }
+    stats_clock_.start();
+    stats_timer_->start(kStatsIntervalMs);
+    emit listeningChanged(true);
+    return true;
+}
+
+void ReceiveServer::Stop()
+{
+    const bool was_listening = isListening();
+    close();
+    stats_timer_->stop();
+    // 在各工作线程中销毁其全部连接，未完成的文件随会话关闭
+    for (auto host : std::as_const(worker_hosts_)) {
+        QMetaObject::invokeMethod(host, [host] {
+            qDeleteAll(host->findChildren<ReceiveConnection *>(Qt::FindDirectChildrenOnly));
+        }, Qt::BlockingQueuedConnection);
+    }
+    for (auto thread : std::as_const(worker_threads_)) {
+        thread->quit();
+        thread->wait();
+    }
+    qDeleteAll(worker_hosts_);
+    qDeleteAll(worker_threads_);
+    worker_hosts_.clear();
+    worker_threads_.clear();
+    worker_loads_.clear();
+    {
+        QMutexLocker locker(&stats_mutex_);
+        connections_.clear();
+        closed_bytes_ = 0;
+    }
+    if (was_listening) {
+        emit listeningChanged(false);
+    }
+}
+
+QList<ReceiveServer::ConnectionStats> ReceiveServer::get_connection_stats() const
+{
+    QMutexLocker locker(&stats_mutex_);
+    QList<ConnectionStats> stats;
+    stats.reserve(connections_.size());
+    for (auto it = connections_.cbegin(); it != connections_.cend(); ++it) {
+        ConnectionStats item;
+        item.connection_id = it.key();
+        item.peer = it->peer;
+        item.bytes_received = it->counters->bytes_received;
+        item.files_completed = it->counters->files_completed;
+        item.files_failed = it->counters->files_failed;
+        item.bytes_per_second = it->bytes_per_second;
+        stats.append(item);
+    }
+    return stats;
+}
+
+void ReceiveServer::incomingConnection(qintptr socket_descriptor)
+{
+    if (worker_hosts_.isEmpty()) {
+        return;
+    }
+    // 选择当前连接数最少的工作线程
+    int worker_index{ 0 };
+    for (int i{ 1 }; i < worker_loads_.size(); ++i) {
+        if (worker_loads_[i] < worker_loads_[worker_index]) {
+            worker_index = i;
+        }
+    }
+    const auto connection_id = next_connection_id_++;
+    QString receive_directory;
+    {
+        QMutexLocker locker(&stats_mutex_);
+        receive_directory = receive_directory_;
+    }
+    // 在服务器线程构造，套接字尚未接管描述符，整体移入工作线程后再打开
+    auto connection = new ReceiveConnection(connection_id, receive_directory, worker_hosts_[worker_index]);
+    ConnectionEntry entry;
+    entry.worker_index = worker_index;
+    entry.counters = connection->get_counters();
+    {
+        QMutexLocker locker(&stats_mutex_);
+        connections_.insert(connection_id, entry);
+    }
+    ++worker_loads_[worker_index];
+    connect(connection, &ReceiveConnection::opened, this, &ReceiveServer::onConnectionOpened);
+    connect(connection, &ReceiveConnection::closed, this, &ReceiveServer::onConnectionClosed);
+    connect(connection, &ReceiveConnection::fileReceiveCompleted, this, &ReceiveServer::fileReceiveCompleted);
+    connect(connection, &ReceiveConnection::fileReceiveError, this, &ReceiveServer::fileReceiveError);
+    connection->moveToThread(worker_threads_[worker_index]);
+    QMetaObject::invokeMethod(connection, [connection, socket_descriptor] {
+        connection->Open(socket_descriptor);
+    });
+}
+
+void ReceiveServer::onConnectionOpened(quint64 connection_id, const QString &peer)
+{
+    {
+        QMutexLocker locker(&stats_mutex_);
+        const auto it = connections_.find(connection_id);
+        if (it == connections_.end()) {
+            return;
+        }
+        it->peer = peer;
+    }
+    emit connectionOpened(connection_id, peer);
+}
+
+void ReceiveServer::onConnectionClosed(quint64 connection_id)
+{
+    ConnectionEntry entry;
+    {
+        QMutexLocker locker(&stats_mutex_);
+        if (!connections_.contains(connection_id)) {
+            return;
+        }
+        entry = connections_.take(connection_id);
+        closed_bytes_ += entry.counters->bytes_received;
+    }
+    if (entry.worker_index < worker_loads_.size()) {
+        --worker_loads_[entry.worker_index];
+    }
+    emit connectionClosed(connection_id, entry.peer);
+}
+
+void ReceiveServer::UpdateStats()
+{
+    // 由各连接的原子计数求差得到吞吐率，不打扰工作线程
+    const double elapsed_seconds = stats_clock_.restart() / 1000.0;
+    int connection_count{ 0 };
+    qint64 total_bytes{ 0 };
+    double total_rate{ 0.0 };
+    {
+        QMutexLocker locker(&stats_mutex_);
+        for (auto &entry : connections_) {
+            const qint64 bytes = entry.counters->bytes_received;
+            entry.bytes_per_second = elapsed_seconds > 0.0 ? (bytes - entry.last_bytes) / elapsed_seconds : 0.0;
+            entry.last_bytes = bytes;
+            total_bytes += bytes;
+            total_rate += entry.bytes_per_second;
+        }
+        connection_count = connections_.size();
+        total_bytes += closed_bytes_;
+    }
+    emit statsUpdated(connection_count, total_bytes, total_rate);
+}
@@ -0,0 +1,126 @@
+﻿#pragma once
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <QMutex>
+#include <QHash>
+#include <QElapsedTimer>
+#include <memory>
+#include "receivesession.h"
+
+// 服务器模式下的单条连接：在工作线程中持有套接字与接收会话，连接断开后自行销毁
+class ReceiveConnection : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 在服务器线程构造后移入工作线程，再在工作线程中调用 Open
+    ReceiveConnection(quint64 connection_id, const QString &receive_directory, QObject *worker_host);
+    ~ReceiveConnection();
+
+    void Open(qintptr socket_descriptor);
+    std::shared_ptr<const ReceiveSession::Counters> get_counters() const { return receive_session_->get_counters(); }
+
+signals:
+    void opened(quint64 connection_id, const QString &peer);
+    void closed(quint64 connection_id);
+    void fileReceiveCompleted(const QString &peer, const QString &saved_file_path);
+    void fileReceiveError(const QString &peer, const QString &error_message);
+
+private slots:
+    void onDisconnected();
+    void onProtocolError(const QString &error_message);
+
+private:
+    quint64 connection_id_;
+    QString receive_directory_;
+    QObject *worker_host_;
+    QString peer_;
+    QTcpSocket *socket_;
+    ReceiveSession *receive_session_;
+    // 连接数较多，内核接收缓冲比客户端模式小
+    static constexpr int kSocketReceiveBufferSize{ 1024 * 1024 };
+};
+
+// 多发送端接收服务器：接受任意数量的并发连接，按负载分配到固定的工作线程池，
+// 每条连接拥有独立的接收会话，各发送端的文件保存在以其地址命名的子目录中。
+// Start/Stop 需在服务器所在线程调用，统计与设置接口可在任意线程调用
+class ReceiveServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    struct ConnectionStats {
+        quint64 connection_id{ 0 };
+        QString peer;
+        qint64 bytes_received{ 0 };
+        int files_completed{ 0 };
+        int files_failed{ 0 };
+        double bytes_per_second{ 0.0 };
+    };
+
+    ReceiveServer(QObject *parent);
+    ~ReceiveServer();
+
+    bool Start(const QString &ip, const QString &port);
+    void Stop();
+
+    void set_receive_directory(const QString &directory_path) { QMutexLocker locker(&stats_mutex_); receive_directory_ = directory_path; }
+    // 工作线程数，下次 Start 时生效；0 表示按 CPU 核数
+    void set_worker_count(int worker_count) { worker_count_ = worker_count; }
+
+    QString get_error_message() const { QMutexLocker locker(&stats_mutex_); return error_message_; }
+    QList<ConnectionStats> get_connection_stats() const;
+
+signals:
+    void listeningChanged(bool listening);
+    void connectionOpened(quint64 connection_id, const QString &peer);
+    void connectionClosed(quint64 connection_id, const QString &peer);
+    void fileReceiveCompleted(const QString &peer, const QString &saved_file_path);
+    void fileReceiveError(const QString &peer, const QString &error_message);
+    // 每秒汇总一次：当前连接数、累计接收字节数与总吞吐率
+    void statsUpdated(int connection_count, qint64 total_bytes, double bytes_per_second);
+
+protected:
+    void incomingConnection(qintptr socket_descriptor) override;
+
+private slots:
+    void onConnectionOpened(quint64 connection_id, const QString &peer);
+    void onConnectionClosed(quint64 connection_id);
+    void UpdateStats();
+
+private:
+    struct ConnectionEntry {
+        QString peer;
+        int worker_index{ 0 };
+        std::shared_ptr<const ReceiveSession::Counters> counters;
+        qint64 last_bytes{ 0 };
+        double bytes_per_second{ 0.0 };
+    };
+
+    void SetErrorMessage(const QString &error_message) { QMutexLocker locker(&stats_mutex_); error_message_ = error_message; }
+
+private:
+    // 保护连接表、接收目录与错误信息
+    mutable QMutex stats_mutex_;
+    QString error_message_;
+    QString receive_directory_;
+    int worker_count_{ 0 };
+
+    // 工作线程及其中的宿主对象，连接挂在宿主下，停止时在各自线程中统一销毁
+    QList<QThread *> worker_threads_;
+    QList<QObject *> worker_hosts_;
+    QList<int> worker_loads_;
+
+    QHash<quint64, ConnectionEntry> connections_;
+    quint64 next_connection_id_{ 1 };
+    qint64 closed_bytes_{ 0 };
+
+    QTimer *stats_timer_;
+    QElapsedTimer stats_clock_;
+    static constexpr int kStatsIntervalMs{ 1000 };
+    static constexpr int kMaxPendingConnections{ 128 };
+};
@@ -0,0 +1,489 @@
+﻿#include "receivesession.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QtEndian>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "checksum.h"
+#include "sessionprotocol.h"
+#include "metrics.h"
+
+
+ReceiveSession::ReceiveSession(QIODevice *device, QObject *parent)
+    : QObject(parent)
+    , device_(device)
+    , counters_(std::make_shared<Counters>())
+    , receive_directory_(QDir::currentPath())
+    , receive_chunk_(kReceiveChunkSize, Qt::Uninitialized)
+{
+    connect(device_, &QIODevice::readyRead, this, &ReceiveSession::ProcessIncomingData);
+}
+
+ReceiveSession::~ReceiveSession()
+{
+    const auto file_ids = active_files_.keys();
+    for (const auto file_id : file_ids) {
+        CloseFile(file_id);
+    }
+}
+
+void ReceiveSession::set_receive_directory(const QString &directory_path)
+{
+    if (QDir(directory_path).exists()) {
+        QMutexLocker locker(&settings_mutex_);
+        receive_directory_ = directory_path;
+    }
+}
+
+void ReceiveSession::set_stream_demodulation(bool enabled, const QString &demodulate_t, const QString &decode_t,
+                                             const ModemParams &params)
+{
+    // 新设置从下一个文件开始生效
+    QMutexLocker locker(&settings_mutex_);
+    stream_demodulation_enabled_ = enabled;
+    stream_demodulate_t_ = demodulate_t;
+    stream_decode_t_ = decode_t;
+    stream_modem_params_ = params;
+}
+
+void ReceiveSession::ProcessIncomingData()
+{
+    // 循环处理设备缓冲中的全部数据：一次 readyRead 中可能包含多个帧，
+    // 也可能包含多个文件的数据，逐个负载处理，不丢弃后续文件的字节
+    while (device_->bytesAvailable() > 0) {
+        if (payload_remaining_ == 0) {
+            if (!ReadNextHeader()) {
+                return;
+            }
+            continue;
+        }
+        // 负载从设备直接读入固定的复用缓冲区，再写入文件，不做拼接、截取或前移
+        const qint64 bytes_to_read = qMin(static_cast<qint64>(receive_chunk_.size()), payload_remaining_);
+        qint64 bytes_read{ 0 };
+        {
+            Metrics::ScopedTimer timer(Metrics::kSocketRead);
+            bytes_read = device_->read(receive_chunk_.data(), bytes_to_read);
+            timer.set_bytes(qMax<qint64>(bytes_read, 0));
+        }
+        if (bytes_read <= 0) {
+            return;
+        }
+        payload_remaining_ -= bytes_read;
+        counters_->bytes_received += bytes_read;
+        if (payload_is_frame_) {
+            frame_crc_ = Checksum::Crc32c(receive_chunk_.constData(), bytes_read, frame_crc_);
+        }
+        // 所属文件已失败或未知时仅读出丢弃，保持帧边界同步
+        const auto file = active_files_.value(payload_file_id_);
+        if (file) {
+            if (file->bytes_received + bytes_read > file->file_size) {
+                FailFile(payload_file_id_, "数据超出声明的文件大小: " + file->file_name);
+                continue;
+            }
+            qint64 bytes_written{ 0 };
+            {
+                Metrics::ScopedTimer timer(Metrics::kFileWrite, bytes_read);
+                bytes_written = file->file->write(receive_chunk_.constData(), bytes_read);
+            }
+            if (bytes_written != bytes_read) {
+                FailFile(payload_file_id_, "写入文件失败: " + file->file->errorString());
+                continue;
+            }
+            if (payload_is_frame_) {
+                file->crc = Checksum::Crc32c(receive_chunk_.constData(), bytes_written, file->crc);
+            }
+            // 已落盘的数据同时送入流式解调器
+            if (stream_bound_ && stream_file_id_ == payload_file_id_) {
+                stream_demodulator_->Feed(receive_chunk_.constData(), bytes_written);
+            }
+            file->bytes_received += bytes_written;
+            counters_->active_bytes_received += bytes_written;
+        }
+        if (payload_remaining_ > 0) {
+            continue;
+        }
+        // 负载读取完毕：数据帧校验，旧协议的文件内容结束即文件完成
+        if (payload_is_frame_) {
+            if (file && frame_crc_ != frame_expected_crc_) {
+                if (file->resumable) {
+                    FailFrame(payload_file_id_);
+                    return;
+                }
+                FailFile(payload_file_id_, "数据帧校验失败: " + file->file_name);
+            } else if (file) {
+                // 整帧校验通过后才计入可续传的进度
+                file->verified_bytes = file->bytes_received;
+                file->verified_crc = file->crc;
+                if (file->resumable && file->verified_bytes - file->saved_bytes >= kResumeRecordInterval) {
+                    SaveResumeRecord(*file);
+                }
+            }
+        } else if (file) {
+            CompleteFile(payload_file_id_);
+        }
+    }
+}
+
+bool ReceiveSession::ReadNextHeader()
+{
+    // 以魔数区分会话协议帧与旧协议文件头；旧协议文件头以 QString 长度开头，不会与魔数冲突
+    char magic[SessionProtocol::kMagicSize];
+    if (device_->peek(magic, sizeof(magic)) < SessionProtocol::kMagicSize) {
+        return false;
+    }
+    if (qFromBigEndian<quint32>(magic) == SessionProtocol::kMagic) {
+        return ReadSessionFrame();
+    }
+    return ReadLegacyHeader();
+}
+
+bool ReceiveSession::ReadLegacyHeader()
+{
+    // 借助 QDataStream 事务直接在设备缓冲上解析文件头；
+    // 数据不足时事务回滚，等待下一次 readyRead，不再保留和重复解析自有缓冲
+    QDataStream stream(device_);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream.startTransaction();
+    QString file_name;
+    qint64 file_size;
+    // 尝试读取文件名和文件大小
+    stream >> file_name >> file_size;
+    if (!stream.commitTransaction()) {
+        return false;
+    }
+    if (file_name.isEmpty() || file_size <= 0) {
+        // 文件头已被读出，其后的文件内容长度无从得知，数据流无法再同步，交由持有者断开连接
+        Reset();
+        emit protocolError("无效的文件头", false);
+        return false;
+    }
+    // 无法创建文件时仍读出并丢弃文件内容，保持后续数据的同步
+    BeginFile(SessionProtocol::kLegacyFileId, file_name, file_size, false, 0);
+    payload_file_id_ = SessionProtocol::kLegacyFileId;
+    payload_remaining_ = file_size;
+    payload_is_frame_ = false;
+    return true;
+}
+
+bool ReceiveSession::ReadSessionFrame()
+{
+    QDataStream stream(device_);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream.startTransaction();
+    quint32 magic{ 0 };
+    quint8 type{ 0 };
+    quint32 file_id{ 0 };
+    stream >> magic >> type >> file_id;
+    if (stream.status() != QDataStream::Ok) {
+        stream.rollbackTransaction();
+        return false;
+    }
+    switch (type) {
+    case SessionProtocol::kFileBegin: {
+        QString file_name;
+        qint64 file_size;
+        stream >> file_name >> file_size;
+        if (!stream.commitTransaction()) {
+            return false;
+        }
+        if (file_id == SessionProtocol::kLegacyFileId || file_name.isEmpty() || file_size < 0) {
+            emit fileReceiveError("无效的文件头");
+            return true;
+        }
+        BeginFile(file_id, file_name, file_size, false, 0);
+        return true;
+    }
+    case SessionProtocol::kFileResume: {
+        QString file_name;
+        qint64 file_size;
+        quint64 content_tag;
+        stream >> file_name >> file_size >> content_tag;
+        if (!stream.commitTransaction()) {
+            return false;
+        }
+        if (file_id == SessionProtocol::kLegacyFileId || file_name.isEmpty() || file_size < 0) {
+            emit fileReceiveError("无效的文件头");
+            return true;
+        }
+        // 无论能否续传都回复偏移，发送端据此开始发送数据帧
+        const auto file = BeginFile(file_id, file_name, file_size, true, content_tag) ? active_files_.value(file_id) : nullptr;
+        SendResumeOffset(file_id, file ? file->bytes_received : 0);
+        return true;
+    }
+    case SessionProtocol::kFileData: {
+        quint32 length;
+        quint32 crc;
+        stream >> length >> crc;
+        if (!stream.commitTransaction()) {
+            return false;
+        }
+        if (length > SessionProtocol::kMaxFramePayload) {
+            break;
+        }
+        payload_file_id_ = file_id;
+        payload_remaining_ = length;
+        payload_is_frame_ = true;
+        frame_crc_ = 0;
+        frame_expected_crc_ = crc;
+        return true;
+    }
+    case SessionProtocol::kFileEnd: {
+        quint32 crc;
+        stream >> crc;
+        if (!stream.commitTransaction()) {
+            return false;
+        }
+        FinishFile(file_id, crc);
+        return true;
+    }
+    default:
+        // 类型未知：负载长度无从得知，后续数据无法再同步
+        stream.abortTransaction();
+        break;
+    }
+    // 协议错误：交由持有者断开连接，由发送端重新建立会话
+    const bool can_resume = HasResumableFiles();
+    Reset();
+    emit protocolError("会话协议错误：无法识别的数据帧", can_resume);
+    return false;
+}
+
+bool ReceiveSession::BeginFile(quint32 file_id, const QString &file_name, qint64 file_size, bool resumable, quint64 content_tag)
+{
+    // 同一 ID 重复开始视为前一个文件被放弃
+    if (active_files_.contains(file_id)) {
+        FailFile(file_id, "文件传输未结束即被重新开始: " + active_files_.value(file_id)->file_name);
+    }
+    auto file = new FileReceiveState;
+    file->file_name = file_name;
+    file->file_size = file_size;
+    file->resumable = resumable;
+    file->content_tag = content_tag;
+    file->save_path = QDir(get_receive_directory()).filePath(QFileInfo(file_name).fileName());
+    // 准备接收文件，负载已按大块写入，无需 QFile 的内部缓冲
+    if (resumable) {
+        file->file = new QFile(file->save_path + ".part", this);
+        if (OpenResumableFile(*file) < 0) {
+            emit fileReceiveError("无法创建文件: " + file->file->fileName());
+            delete file->file;
+            delete file;
+            return false;
+        }
+    } else {
+        file->file = new QFile(file->save_path, this);
+        if (!file->file->open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+            emit fileReceiveError("无法创建文件: " + file->save_path);
+            delete file->file;
+            delete file;
+            return false;
+        }
+    }
+    active_files_.insert(file_id, file);
+    counters_->active_bytes_total += file->file_size;
+    counters_->active_bytes_received += file->bytes_received;
+    receiving_ = true;
+    {
+        // 续传的文件缺少开头的数据，不送入流式解调器
+        QMutexLocker locker(&settings_mutex_);
+        if (stream_demodulator_ && stream_demodulation_enabled_ && !stream_bound_ && file->bytes_received == 0) {
+            stream_demodulator_->Start(stream_demodulate_t_, stream_decode_t_, stream_modem_params_);
+            stream_bound_ = true;
+            stream_file_id_ = file_id;
+        }
+    }
+    emit fileReceiveStarted(file_name, file_size);
+    return true;
+}
+
+qint64 ReceiveSession::OpenResumableFile(FileReceiveState &file)
+{
+    // 续传记录与 .part 文件均存在且文件名、大小、内容标识一致时从记录的偏移继续，否则从头接收
+    const QString record_path = file.file->fileName() + ".resume";
+    QFile record_file(record_path);
+    qint64 offset{ 0 };
+    quint32 crc{ 0 };
+    if (record_file.open(QIODevice::ReadOnly)) {
+        const auto record = QJsonDocument::fromJson(record_file.readAll()).object();
+        record_file.close();
+        if (record.value("file_name").toString() == file.file_name
+            && record.value("file_size").toString().toLongLong() == file.file_size
+            && record.value("content_tag").toString().toULongLong() == file.content_tag) {
+            offset = record.value("bytes").toString().toLongLong();
+            crc = static_cast<quint32>(record.value("crc").toString().toUInt());
+        }
+    }
+    if (offset <= 0 || offset > file.file_size || !file.file->open(QIODevice::ReadWrite | QIODevice::Unbuffered)
+        || file.file->size() < offset) {
+        file.file->close();
+        QFile::remove(record_path);
+        offset = 0;
+        crc = 0;
+        if (!file.file->open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+            return -1;
+        }
+    }
+    // 记录之后写入的数据未经校验，截掉后从记录处继续
+    if (!file.file->resize(offset) || !file.file->seek(offset)) {
+        file.file->close();
+        return -1;
+    }
+    file.bytes_received = offset;
+    file.crc = crc;
+    file.verified_bytes = offset;
+    file.verified_crc = crc;
+    file.saved_bytes = offset;
+    return offset;
+}
+
+bool ReceiveSession::SaveResumeRecord(FileReceiveState &file)
+{
+    // 64 位整数以字符串保存，避免 JSON 数值的精度损失
+    QJsonObject record;
+    record.insert("file_name", file.file_name);
+    record.insert("file_size", QString::number(file.file_size));
+    record.insert("content_tag", QString::number(file.content_tag));
+    record.insert("bytes", QString::number(file.verified_bytes));
+    record.insert("crc", QString::number(file.verified_crc));
+    // 先落盘数据再原子替换记录，记录中的偏移不会超过文件中实际已写入的数据
+    file.file->flush();
+    QSaveFile record_file(file.file->fileName() + ".resume");
+    if (!record_file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    record_file.write(QJsonDocument(record).toJson(QJsonDocument::Compact));
+    if (!record_file.commit()) {
+        return false;
+    }
+    file.saved_bytes = file.verified_bytes;
+    return true;
+}
+
+void ReceiveSession::SendResumeOffset(quint32 file_id, qint64 offset)
+{
+    QDataStream stream(device_);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << SessionProtocol::kMagic << static_cast<quint8>(SessionProtocol::kResumeOffset) << file_id << offset;
+}
+
+void ReceiveSession::FailFrame(quint32 file_id)
+{
+    // 可续传文件的数据帧损坏：回退到上一个完整帧并保存记录，断开连接后由发送端重连续传，
+    // 之前已经收到的数据无需重新发送
+    const auto file = active_files_.value(file_id);
+    const auto error_message = QString("数据帧校验失败，等待重连后从 %1 字节处续传: %2")
+                                   .arg(file->verified_bytes)
+                                   .arg(file->file_name);
+    Reset();
+    emit fileReceiveError(error_message);
+    emit protocolError(error_message, true);
+}
+
+bool ReceiveSession::HasResumableFiles() const
+{
+    for (const auto file : active_files_) {
+        if (file->resumable) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ReceiveSession::FinishFile(quint32 file_id, quint32 file_crc)
+{
+    const auto file = active_files_.value(file_id);
+    if (!file) {
+        return;
+    }
+    if (file->bytes_received != file->file_size) {
+        FailFile(file_id, QString("文件不完整: %1 (%2/%3 字节)")
+                          .arg(file->file_name)
+                          .arg(file->bytes_received)
+                          .arg(file->file_size));
+        return;
+    }
+    if (file->crc != file_crc) {
+        FailFile(file_id, "文件校验失败: " + file->file_name);
+        return;
+    }
+    CompleteFile(file_id);
+}
+
+void ReceiveSession::CompleteFile(quint32 file_id)
+{
+    const auto file = active_files_.value(file_id);
+    const QString saved_path = file->save_path;
+    const QString part_path = file->file->fileName();
+    const bool resumable = file->resumable;
+    if (stream_bound_ && stream_file_id_ == file_id) {
+        stream_demodulator_->Finish();
+        stream_bound_ = false;
+    }
+    // 先标记为已完成，避免关闭时再写入续传记录
+    file->resumable = false;
+    CloseFile(file_id);
+    if (resumable) {
+        QFile::remove(part_path + ".resume");
+        QFile::remove(saved_path);
+        QFile::rename(part_path, saved_path);
+    }
+    ++counters_->files_completed;
+    emit fileReceiveCompleted(saved_path);
+}
+
+void ReceiveSession::FailFile(quint32 file_id, const QString &error_message)
+{
+    // 删除不完整或校验失败的文件，避免被误当作有效采样
+    const auto file = active_files_.value(file_id);
+    const QString saved_path = file->file->fileName();
+    const bool resumable = file->resumable;
+    file->resumable = false;
+    CloseFile(file_id);
+    QFile::remove(saved_path);
+    if (resumable) {
+        QFile::remove(saved_path + ".resume");
+    }
+    ++counters_->files_failed;
+    emit fileReceiveError(error_message);
+}
+
+void ReceiveSession::CloseFile(quint32 file_id)
+{
+    const auto file = active_files_.take(file_id);
+    if (!file) {
+        return;
+    }
+    counters_->active_bytes_total -= file->file_size;
+    counters_->active_bytes_received -= file->bytes_received;
+    // 未完成的可续传文件截掉未校验的尾部并保存记录，留待重连后续传
+    if (file->resumable) {
+        file->file->resize(file->verified_bytes);
+        SaveResumeRecord(*file);
+    }
+    file->file->close();
+    delete file->file;
+    delete file;
+    if (stream_bound_ && stream_file_id_ == file_id) {
+        stream_demodulator_->Reset();
+        stream_bound_ = false;
+    }
+    if (active_files_.isEmpty()) {
+        receiving_ = false;
+    }
+}
+
+void ReceiveSession::Reset()
+{
+    const auto file_ids = active_files_.keys();
+    for (const auto file_id : file_ids) {
+        CloseFile(file_id);
+    }
+    if (stream_demodulator_) {
+        stream_demodulator_->Reset();
+    }
+    stream_bound_ = false;
+    receiving_ = false;
+    payload_remaining_ = 0;
+    payload_is_frame_ = false;
+}
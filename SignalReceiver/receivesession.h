@@ -0,0 +1,116 @@
+﻿#pragma once
+
+#include <QObject>
+#include <QIODevice>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <atomic>
+#include <memory>
+#include "streamdemodulator.h"
+
+// 接收会话：解析一条连接上的旧协议文件头或会话协议帧并将文件落盘。
+// 不关心连接的建立方式，客户端模式与服务器模式的每条连接各持有一个会话，
+// 会话与其设备必须位于同一线程；设置接口与统计计数可在任意线程访问。
+// 接收进度不逐块发信号，由 ProgressReporter 按固定频率读取统计计数
+class ReceiveSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 会话统计计数，以共享指针提供给其他线程读取，会话销毁后仍然有效
+    struct Counters {
+        std::atomic<qint64> bytes_received{ 0 };
+        // 当前未完成文件的已接收字节数与总字节数，供进度采样
+        std::atomic<qint64> active_bytes_received{ 0 };
+        std::atomic<qint64> active_bytes_total{ 0 };
+        std::atomic<int> files_completed{ 0 };
+        std::atomic<int> files_failed{ 0 };
+    };
+
+    ReceiveSession(QIODevice *device, QObject *parent);
+    ~ReceiveSession();
+
+    void ProcessIncomingData();
+    void Reset();
+
+    void set_receive_directory(const QString &directory_path);
+    void set_stream_demodulator(StreamDemodulator *stream_demodulator) { stream_demodulator_ = stream_demodulator; }
+    void set_stream_demodulation(bool enabled, const QString &demodulate_t, const QString &decode_t,
+                                 const ModemParams &params = ModemParams());
+
+    bool IsReceiving() const { return receiving_; }
+    // 是否有未完成的可续传文件，连接中断后值得自动重连
+    bool HasResumableFiles() const;
+    QString get_receive_directory() const { QMutexLocker locker(&settings_mutex_); return receive_directory_; }
+    std::shared_ptr<const Counters> get_counters() const { return counters_; }
+
+signals:
+    void fileReceiveStarted(const QString &file_name, qint64 file_size);
+    void fileReceiveCompleted(const QString &saved_file_path);
+    void fileReceiveError(const QString &error_message);
+    // 数据流已无法同步，持有者应断开连接；can_resume 表示有可续传的文件等待重连
+    void protocolError(const QString &error_message, bool can_resume);
+
+private:
+    // 单个文件的接收状态
+    struct FileReceiveState {
+        QString file_name;
+        qint64 file_size{ 0 };
+        qint64 bytes_received{ 0 };
+        quint32 crc{ 0 };
+        QFile *file{ nullptr };
+        // 可续传文件先写入 .part，已校验的进度记录在旁边的续传记录中
+        bool resumable{ false };
+        quint64 content_tag{ 0 };
+        QString save_path;
+        qint64 verified_bytes{ 0 };
+        quint32 verified_crc{ 0 };
+        qint64 saved_bytes{ 0 };
+    };
+
+    bool ReadNextHeader();
+    bool ReadLegacyHeader();
+    bool ReadSessionFrame();
+    bool BeginFile(quint32 file_id, const QString &file_name, qint64 file_size, bool resumable, quint64 content_tag);
+    qint64 OpenResumableFile(FileReceiveState &file);
+    bool SaveResumeRecord(FileReceiveState &file);
+    void SendResumeOffset(quint32 file_id, qint64 offset);
+    void FailFrame(quint32 file_id);
+    void FinishFile(quint32 file_id, quint32 file_crc);
+    void CompleteFile(quint32 file_id);
+    void FailFile(quint32 file_id, const QString &error_message);
+    void CloseFile(quint32 file_id);
+
+private:
+    QIODevice *device_;
+    std::shared_ptr<Counters> counters_;
+    std::atomic<bool> receiving_{ false };
+
+    // 保护可被其他线程读写的设置
+    mutable QMutex settings_mutex_;
+    QString receive_directory_;
+    bool stream_demodulation_enabled_{ false };
+    QString stream_demodulate_t_;
+    QString stream_decode_t_;
+    ModemParams stream_modem_params_;
+
+    // 会话协议下同一连接可同时存在多个未完成的文件
+    QHash<quint32, FileReceiveState *> active_files_;
+    // 当前正在读取的负载：旧协议为整个文件内容，会话协议为一个数据帧
+    quint32 payload_file_id_{ 0 };
+    qint64 payload_remaining_{ 0 };
+    bool payload_is_frame_{ false };
+    quint32 frame_crc_{ 0 };
+    quint32 frame_expected_crc_{ 0 };
+    // 复用的固定接收缓冲区，负载经此从设备写入文件
+    QByteArray receive_chunk_;
+    static constexpr qsizetype kReceiveChunkSize{ 256 * 1024 };
+    // 续传记录的更新间隔（已校验字节数），断线最多重传这么多数据
+    static constexpr qint64 kResumeRecordInterval{ 4 * 1024 * 1024 };
+
+    // 流式解调器同一时间只跟随一个文件，其余并发文件仅落盘
+    StreamDemodulator *stream_demodulator_{ nullptr };
+    bool stream_bound_{ false };
+    quint32 stream_file_id_{ 0 };
+};
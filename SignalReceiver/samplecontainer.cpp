@@ -0,0 +1,138 @@
+﻿#include "samplecontainer.h"
+#include <QtEndian>
+#include <cstring>
+
+namespace SampleContainer {
+
+namespace {
+
+template <typename T>
+T ReadLittleEndian(const char *data)
+{
+    return qFromLittleEndian<T>(data);
+}
+
+template <typename T>
+void WriteLittleEndian(char *data, T value)
+{
+    qToLittleEndian<T>(value, data);
+}
+
+double ReadDouble(const char *data)
+{
+    const auto bits = ReadLittleEndian<quint64>(data);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void WriteDouble(char *data, double value)
+{
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteLittleEndian<quint64>(data, bits);
+}
+
+}
+
+bool HasMagic(const char *data, qint64 size)
+{
+    return size >= static_cast<qint64>(sizeof(kMagic)) && memcmp(data, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool ReadHeader(const char *data, qint64 size, Header &header, QString *error_message)
+{
+    const auto fail = [error_message](const QString &message) {
+        if (error_message) {
+            *error_message = message;
+        }
+        return false;
+    };
+    if (size < kHeaderSize || !HasMagic(data, size)) {
+        return fail("不是有效的二进制采样文件");
+    }
+    header.version = ReadLittleEndian<quint16>(data + 4);
+    if (header.version == 0 || header.version > kVersion) {
+        return fail(QString("不支持的采样文件版本: %1").arg(header.version));
+    }
+    const auto sample_type = static_cast<quint8>(data[6]);
+    if (sample_type < kInt16 || sample_type > kFloat64) {
+        return fail(QString("未知的采样类型: %1").arg(sample_type));
+    }
+    header.sample_type = static_cast<SampleType>(sample_type);
+    header.sample_rate = ReadDouble(data + 8);
+    header.samples_per_bit = ReadLittleEndian<quint32>(data + 16);
+    header.carrier_freq = ReadDouble(data + 24);
+    header.sample_count = ReadLittleEndian<quint64>(data + 32);
+    if (header.sample_rate <= 0.0 || header.samples_per_bit == 0) {
+        return fail("采样参数无效");
+    }
+    return true;
+}
+
+QByteArray WriteHeader(const Header &header)
+{
+    QByteArray bytes(kHeaderSize, '\0');
+    auto *data = bytes.data();
+    memcpy(data, kMagic, sizeof(kMagic));
+    WriteLittleEndian<quint16>(data + 4, header.version ? header.version : kVersion);
+    data[6] = static_cast<char>(header.sample_type);
+    WriteDouble(data + 8, header.sample_rate);
+    WriteLittleEndian<quint32>(data + 16, header.samples_per_bit);
+    WriteDouble(data + 24, header.carrier_freq);
+    WriteLittleEndian<quint64>(data + 32, header.sample_count);
+    return bytes;
+}
+
+qint64 SampleSize(SampleType sample_type)
+{
+    switch (sample_type) {
+    case kInt16:
+        return 2;
+    case kFloat32:
+        return 4;
+    case kFloat64:
+        return 8;
+    }
+    return 0;
+}
+
+QString SampleTypeName(SampleType sample_type)
+{
+    switch (sample_type) {
+    case kInt16:
+        return "int16";
+    case kFloat32:
+        return "float32";
+    case kFloat64:
+        return "float64";
+    }
+    return "unknown";
+}
+
+void ConvertToDouble(const char *data, SampleType sample_type, qint64 count, double *out)
+{
+    switch (sample_type) {
+    case kInt16:
+        // 整型采样归一化到 [-1, 1)
+        for (qint64 i{ 0 }; i < count; ++i) {
+            out[i] = ReadLittleEndian<qint16>(data + i * 2) / 32768.0;
+        }
+        break;
+    case kFloat32:
+        for (qint64 i{ 0 }; i < count; ++i) {
+            const auto bits = ReadLittleEndian<quint32>(data + i * 4);
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            out[i] = value;
+        }
+        break;
+    case kFloat64:
+        for (qint64 i{ 0 }; i < count; ++i) {
+            out[i] = ReadDouble(data + i * 8);
+        }
+        break;
+    }
+}
+
+}
@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QString>
+
+// 二进制采样容器：紧随 (文件名, 文件大小) 这一 QDataStream 文件头之后发送，
+// 计入文件大小并原样落盘。首字节 0x89 不可能出现在 ASCII 采样文本的开头，
+// 因此接收端只需查看负载的前 4 字节即可区分二进制容器与旧版文本格式。
+//
+// 布局（小端）：
+//   0  magic[4]        "\x89SRB"
+//   4  quint16 version
+//   6  quint8  sample_type
+//   7  quint8  reserved
+//   8  double  sample_rate
+//   16 quint32 samples_per_bit
+//   20 quint32 reserved
+//   24 double  carrier_freq
+//   32 quint64 sample_count
+//   40 采样数据（小端），头部长度保证 float64 采样 8 字节对齐
+namespace SampleContainer {
+
+enum SampleType : quint8 {
+    kInt16 = 1,
+    kFloat32 = 2,
+    kFloat64 = 3
+};
+
+struct Header {
+    quint16 version{ 0 };
+    SampleType sample_type{ kFloat64 };
+    double sample_rate{ 0.0 };
+    quint32 samples_per_bit{ 0 };
+    double carrier_freq{ 0.0 };
+    quint64 sample_count{ 0 };
+};
+
+constexpr char kMagic[4]{ '\x89', 'S', 'R', 'B' };
+constexpr quint16 kVersion{ 1 };
+constexpr qint64 kHeaderSize{ 40 };
+
+// 至少需要 4 字节才能判断
+bool HasMagic(const char *data, qint64 size);
+bool ReadHeader(const char *data, qint64 size, Header &header, QString *error_message = nullptr);
+QByteArray WriteHeader(const Header &header);
+qint64 SampleSize(SampleType sample_type);
+QString SampleTypeName(SampleType sample_type);
+// 将 count 个小端采样转换为 double 写入 out
+void ConvertToDouble(const char *data, SampleType sample_type, qint64 count, double *out);
+
+}
@@ -0,0 +1,319 @@
+﻿#include "sampleconvert.h"
+#include <emmintrin.h>
+#include <cstring>
+#include <cmath>
+#include <QtMath>
+
+namespace SampleConvert {
+
+namespace {
+
+// 32 位整数满量程，float 输出上限取小于 1 的最大值以免放大后溢出
+constexpr float kInt16Scale{ 32768.0f };
+constexpr float kInt24Scale{ 8388608.0f };
+constexpr float kInt32Scale{ 2147483648.0f };
+constexpr float kMaxBelowOne{ 0.99999994f };
+// 抗混叠低通：通带到输出采样率的 0.4 倍，阻带从 0.5 倍开始；
+// Hamming 窗阻带衰减约 53 dB，所需长度约为 3.3 / 过渡带宽（相对输入采样率）
+constexpr double kPassbandEdge{ 0.4 };
+constexpr double kStopbandEdge{ 0.5 };
+constexpr double kHammingLengthFactor{ 3.3 };
+
+float DotProduct(const float *a, const float *b, qsizetype count)
+{
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    qsizetype i{ 0 };
+    for (; i + 8 <= count; i += 8) {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(sum0, sum1));
+    float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < count; ++i) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void DecodeInt16(const qint16 *in, qsizetype count, float *out)
+{
+    const __m128 scale = _mm_set1_ps(1.0f / kInt16Scale);
+    qsizetype i{ 0 };
+    for (; i + 8 <= count; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        // 16 位有符号扩展为 32 位：放到高半部分后算术右移
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+    for (; i < count; ++i) {
+        out[i] = in[i] / kInt16Scale;
+    }
+}
+
+void DecodeInt32(const qint32 *in, qsizetype count, float *out)
+{
+    const __m128 scale = _mm_set1_ps(1.0f / kInt32Scale);
+    qsizetype i{ 0 };
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+    }
+    for (; i < count; ++i) {
+        out[i] = in[i] / kInt32Scale;
+    }
+}
+
+void EncodeInt16(const float *in, qsizetype count, qint16 *out)
+{
+    const __m128 scale = _mm_set1_ps(kInt16Scale);
+    qsizetype i{ 0 };
+    for (; i + 8 <= count; i += 8) {
+        // cvtps 按就近取整，packs 负责饱和到 16 位
+        const __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i), scale));
+        const __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(lo, hi));
+    }
+    for (; i < count; ++i) {
+        out[i] = static_cast<qint16>(qBound(-32768, qRound(in[i] * kInt16Scale), 32767));
+    }
+}
+
+void EncodeInt32(const float *in, qsizetype count, qint32 *out)
+{
+    const __m128 scale = _mm_set1_ps(kInt32Scale);
+    const __m128 low = _mm_set1_ps(-1.0f);
+    const __m128 high = _mm_set1_ps(kMaxBelowOne);
+    qsizetype i{ 0 };
+    for (; i + 4 <= count; i += 4) {
+        const __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), low), high);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_cvtps_epi32(_mm_mul_ps(v, scale)));
+    }
+    for (; i < count; ++i) {
+        out[i] = static_cast<qint32>(qBound(-1.0f, in[i], kMaxBelowOne) * kInt32Scale);
+    }
+}
+
+}
+
+void Decode(const char *in, WavFile::Encoding encoding, qsizetype count, float *out)
+{
+    // WAV 数据为小端，与 x86/x64 一致，可直接按本机字节序读取
+    switch (encoding) {
+    case WavFile::Encoding::kUInt8: {
+        const auto *src = reinterpret_cast<const quint8 *>(in);
+        for (qsizetype i{ 0 }; i < count; ++i) {
+            out[i] = (static_cast<int>(src[i]) - 128) / 128.0f;
+        }
+        break;
+    }
+    case WavFile::Encoding::kInt16: {
+        DecodeInt16(reinterpret_cast<const qint16 *>(in), count, out);
+        break;
+    }
+    case WavFile::Encoding::kInt24: {
+        const auto *src = reinterpret_cast<const quint8 *>(in);
+        for (qsizetype i{ 0 }; i < count; ++i, src += 3) {
+            // 放到 32 位高 24 位，转为有符号后算术右移完成符号扩展
+            const quint32 raw = (quint32(src[0]) << 8) | (quint32(src[1]) << 16) | (quint32(src[2]) << 24);
+            out[i] = (static_cast<qint32>(raw) >> 8) / kInt24Scale;
+        }
+        break;
+    }
+    case WavFile::Encoding::kInt32: {
+        DecodeInt32(reinterpret_cast<const qint32 *>(in), count, out);
+        break;
+    }
+    case WavFile::Encoding::kFloat32: {
+        memcpy(out, in, count * sizeof(float));
+        break;
+    }
+    case WavFile::Encoding::kFloat64: {
+        for (qsizetype i{ 0 }; i < count; ++i) {
+            double value;
+            memcpy(&value, in + i * sizeof(double), sizeof(double));
+            out[i] = static_cast<float>(value);
+        }
+        break;
+    }
+    case WavFile::Encoding::kUnknown:
+        memset(out, 0, count * sizeof(float));
+        break;
+    }
+}
+
+void Encode(const float *in, WavFile::Encoding encoding, qsizetype count, char *out)
+{
+    switch (encoding) {
+    case WavFile::Encoding::kUInt8: {
+        auto *dst = reinterpret_cast<quint8 *>(out);
+        for (qsizetype i{ 0 }; i < count; ++i) {
+            dst[i] = static_cast<quint8>(qBound(0, qRound(in[i] * 128.0f) + 128, 255));
+        }
+        break;
+    }
+    case WavFile::Encoding::kInt16:
+        EncodeInt16(in, count, reinterpret_cast<qint16 *>(out));
+        break;
+    case WavFile::Encoding::kInt24: {
+        auto *dst = reinterpret_cast<quint8 *>(out);
+        for (qsizetype i{ 0 }; i < count; ++i, dst += 3) {
+            const auto value = static_cast<quint32>(qBound(-8388608, qRound(in[i] * kInt24Scale), 8388607));
+            dst[0] = static_cast<quint8>(value);
+            dst[1] = static_cast<quint8>(value >> 8);
+            dst[2] = static_cast<quint8>(value >> 16);
+        }
+        break;
+    }
+    case WavFile::Encoding::kInt32:
+        EncodeInt32(in, count, reinterpret_cast<qint32 *>(out));
+        break;
+    case WavFile::Encoding::kFloat32:
+        memcpy(out, in, count * sizeof(float));
+        break;
+    case WavFile::Encoding::kFloat64:
+        for (qsizetype i{ 0 }; i < count; ++i) {
+            const double value = in[i];
+            memcpy(out + i * sizeof(double), &value, sizeof(double));
+        }
+        break;
+    case WavFile::Encoding::kUnknown:
+        break;
+    }
+}
+
+void MixChannels(const float *in, int in_channels, qsizetype frames, float *out, int out_channels)
+{
+    if (in_channels == out_channels) {
+        memcpy(out, in, frames * in_channels * sizeof(float));
+        return;
+    }
+    if (out_channels == 1) {
+        const float gain = 1.0f / in_channels;
+        for (qsizetype f{ 0 }; f < frames; ++f) {
+            float sum{ 0.0f };
+            for (int c{ 0 }; c < in_channels; ++c) {
+                sum += in[f * in_channels + c];
+            }
+            out[f] = sum * gain;
+        }
+        return;
+    }
+    for (qsizetype f{ 0 }; f < frames; ++f) {
+        const float *src = in + f * in_channels;
+        float *dst = out + f * out_channels;
+        for (int c{ 0 }; c < out_channels; ++c) {
+            dst[c] = in_channels == 1 ? src[0] : (c < in_channels ? src[c] : 0.0f);
+        }
+    }
+}
+
+void Resampler::Reset(int channel_count, double input_rate, double output_rate)
+{
+    channel_count_ = qMax(1, channel_count);
+    step_ = (input_rate > 0.0 && output_rate > 0.0) ? input_rate / output_rate : 1.0;
+    position_ = 0.0;
+    primed_ = false;
+    previous_.resize(channel_count_);
+}
+
+qsizetype Resampler::Process(const float *in, qsizetype frames, QList<float> &out)
+{
+    if (frames <= 0) {
+        return 0;
+    }
+    // 第一块以首帧作为“上一帧”，使第一个输出帧恰好落在输入首帧上
+    if (!primed_) {
+        memcpy(previous_.data(), in, channel_count_ * sizeof(float));
+        primed_ = true;
+    }
+    const qsizetype first = out.size();
+    const qsizetype estimate = static_cast<qsizetype>((frames - position_) / step_) + 2;
+    out.resize(first + estimate * channel_count_);
+    float *dst = out.data() + first;
+    qsizetype produced{ 0 };
+    // 插值需要 floor(position) 与其后一帧，位置 -1 对应上一块的最后一帧
+    while (position_ < frames - 1 && produced < estimate) {
+        const qsizetype index = static_cast<qsizetype>(position_ + 1.0) - 1;
+        const float frac = static_cast<float>(position_ - index);
+        const float *a = index < 0 ? previous_.constData() : in + index * channel_count_;
+        const float *b = in + (index + 1) * channel_count_;
+        for (int c{ 0 }; c < channel_count_; ++c) {
+            dst[c] = a[c] + (b[c] - a[c]) * frac;
+        }
+        dst += channel_count_;
+        ++produced;
+        position_ += step_;
+    }
+    out.resize(first + produced * channel_count_);
+    position_ -= frames;
+    memcpy(previous_.data(), in + (frames - 1) * channel_count_, channel_count_ * sizeof(float));
+    return produced;
+}
+
+void Decimator::Reset(double input_rate, double output_rate)
+{
+    taps_.clear();
+    window_.clear();
+    factor_ = 1;
+    output_rate_ = input_rate;
+    if (input_rate <= 0.0 || output_rate <= 0.0 || input_rate <= output_rate) {
+        return;
+    }
+    // 抽取后的采样率不低于目标采样率，剩余比例在 [1, 2) 内由线性插值完成
+    factor_ = qMax(1, static_cast<int>(input_rate / output_rate));
+    output_rate_ = input_rate / factor_;
+    const double cutoff = (kPassbandEdge + kStopbandEdge) / 2 * output_rate / input_rate;
+    const double transition = (kStopbandEdge - kPassbandEdge) * output_rate / input_rate;
+    const int half = static_cast<int>(std::ceil(kHammingLengthFactor / transition / 2));
+    const int length = 2 * half + 1;
+    taps_.resize(length);
+    double sum{ 0.0 };
+    for (int i{ 0 }; i < length; ++i) {
+        const int n = i - half;
+        const double sinc = n == 0 ? 2 * cutoff : std::sin(2 * M_PI * cutoff * n) / (M_PI * n);
+        const double window = 0.54 + 0.46 * std::cos(M_PI * n / half);
+        taps_[i] = static_cast<float>(sinc * window);
+        sum += taps_[i];
+    }
+    // 直流增益归一化为 1
+    for (auto &tap : taps_) {
+        tap = static_cast<float>(tap / sum);
+    }
+    // 以 taps - 1 个零采样作为首块之前的历史，第一个输出点的窗口中心落在输入首个采样上
+    window_.fill(0.0f, length - 1);
+    next_ = half;
+}
+
+qsizetype Decimator::Process(const float *in, qsizetype frames, QList<float> &out)
+{
+    if (frames <= 0 || taps_.isEmpty()) {
+        return 0;
+    }
+    const qsizetype length = taps_.size();
+    const qsizetype history = length - 1;
+    window_.resize(history + frames);
+    memcpy(window_.data() + history, in, frames * sizeof(float));
+    qsizetype produced{ 0 };
+    for (; next_ + length <= window_.size(); next_ += factor_) {
+        out.append(DotProduct(window_.constData() + next_, taps_.constData(), length));
+        ++produced;
+    }
+    // 保留末尾 taps - 1 个采样供下一块使用
+    memmove(window_.data(), window_.constData() + frames, history * sizeof(float));
+    window_.resize(history);
+    next_ -= frames;
+    return produced;
+}
+
+qsizetype Decimator::Flush(QList<float> &out)
+{
+    // 以零补齐后半个滤波器长度，输出剩余以末尾采样为中心的点
+    const QList<float> zeros(taps_.size() / 2, 0.0f);
+    return Process(zeros.constData(), zeros.size(), out);
+}
+
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+
+#include <QtGlobal>
+#include <QList>
+#include "wavfile.h"
+
+// 采样格式、声道与采样率转换。中间格式统一为 [-1, 1) 的交错 float，
+// 16/32 位整数与 float 之间的转换使用 SSE2（x64 下必然可用），其余格式为无分支的标量循环
+namespace SampleConvert {
+
+// 源编码 → float，count 为样本数（帧数 × 声道数）
+void Decode(const char *in, WavFile::Encoding encoding, qsizetype count, float *out);
+// float → 目标编码，整数编码下超出 [-1, 1) 的样本饱和截断
+void Encode(const float *in, WavFile::Encoding encoding, qsizetype count, char *out);
+// 声道映射：输出单声道时取各声道平均；否则按声道号对应，单声道源复制到所有声道，缺少的声道补零
+void MixChannels(const float *in, int in_channels, qsizetype frames, float *out, int out_channels);
+
+// 流式线性插值重采样，跨块保留上一帧与插值位置，分块结果与整段处理一致
+class Resampler
+{
+public:
+    void Reset(int channel_count, double input_rate, double output_rate);
+    bool IsPassthrough() const { return step_ == 1.0; }
+    // 处理 frames 帧交错输入，结果追加到 out 末尾，返回输出帧数
+    qsizetype Process(const float *in, qsizetype frames, QList<float> &out);
+
+private:
+    int channel_count_{ 1 };
+    double step_{ 1.0 };            // 每个输出帧前进的输入帧数
+    double position_{ 0.0 };        // 下一输出帧在当前块中的位置，-1 表示上一块的最后一帧
+    bool primed_{ false };
+    QList<float> previous_;
+};
+
+// 流式抗混叠抽取（单声道）：大幅降采样前以加窗 sinc 低通滤除目标采样率一半以上的分量，
+// 并按整数倍抽取，只计算保留下来的输出点；剩余的非整数倍比例交给 Resampler。
+// 滤波器以零相位对齐，输出第 k 点对应输入第 k * Factor() 点，末尾需 Flush 补齐
+class Decimator
+{
+public:
+    // 输入采样率不高于输出采样率时为直通
+    void Reset(double input_rate, double output_rate);
+    bool IsPassthrough() const { return taps_.isEmpty(); }
+    int Factor() const { return factor_; }
+    double get_output_rate() const { return output_rate_; }
+    // 处理 frames 个输入采样，结果追加到 out 末尾，返回输出点数
+    qsizetype Process(const float *in, qsizetype frames, QList<float> &out);
+    qsizetype Flush(QList<float> &out);
+
+private:
+    int factor_{ 1 };
+    double output_rate_{ 0.0 };
+    QList<float> taps_;
+    QList<float> window_;           // 上一块末尾 taps - 1 个采样 + 当前块
+    qsizetype next_{ 0 };           // 下一个输出点的滤波窗口在 window_ 中的起点
+};
+
+}
@@ -0,0 +1,43 @@
+﻿#include "samplelistmodel.h"
+#include <limits>
+
+SampleListModel::SampleListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{}
+
+void SampleListModel::set_samples(QSpan<const double> samples)
+{
+    beginResetModel();
+    samples_ = samples;
+    endResetModel();
+}
+
+void SampleListModel::Clear()
+{
+    set_samples(QSpan<const double>());
+}
+
+int SampleListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    // 视图行号为 int，超大文件只显示前 INT_MAX 行
+    const auto rows = (samples_.size() + kSamplesPerRow - 1) / kSamplesPerRow;
+    return static_cast<int>(qMin<qsizetype>(rows, std::numeric_limits<int>::max()));
+}
+
+QVariant SampleListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    const qsizetype first = static_cast<qsizetype>(index.row()) * kSamplesPerRow;
+    const qsizetype last = qMin<qsizetype>(first + kSamplesPerRow, samples_.size());
+    // 行首为首个采样的序号，采样值右对齐便于按列比较
+    QString text = QString("%1 ").arg(first, 10);
+    for (auto i{ first }; i < last; ++i) {
+        text += QString("%1").arg(samples_[i], 11, 'f', 6);
+    }
+    return text;
+}
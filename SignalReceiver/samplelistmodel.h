@@ -0,0 +1,26 @@
+﻿#pragma once
+
+#include <QAbstractListModel>
+#include <QSpan>
+
+// 采样视图模型：每行显示固定个数的采样，只在视图请求某行时才格式化该行，
+// 不复制、不预先生成文本。采样缓冲由 TxtModel 持有，重新加载前需调用 Clear
+class SampleListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    SampleListModel(QObject *parent);
+
+    void set_samples(QSpan<const double> samples);
+    void Clear();
+    qsizetype get_sample_count() const { return samples_.size(); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    static constexpr int kSamplesPerRow{ 8 };
+
+private:
+    QSpan<const double> samples_;
+};
@@ -0,0 +1,88 @@
+﻿#include "sampleparser.h"
+#include <array>
+#include <charconv>
+
+namespace SampleParser {
+
+namespace {
+
+constexpr std::array<bool, 256> kSeparatorTable = [] {
+    std::array<bool, 256> table{};
+    table[static_cast<unsigned char>(' ')] = true;
+    table[static_cast<unsigned char>('\t')] = true;
+    table[static_cast<unsigned char>('\n')] = true;
+    table[static_cast<unsigned char>('\v')] = true;
+    table[static_cast<unsigned char>('\f')] = true;
+    table[static_cast<unsigned char>('\r')] = true;
+    return table;
+}();
+
+}
+
+const char *SkipUtf8Bom(const char *begin, const char *end)
+{
+    if (end - begin >= 3 && begin[0] == '\xEF' && begin[1] == '\xBB' && begin[2] == '\xBF') {
+        return begin + 3;
+    }
+    return begin;
+}
+
+bool IsSeparator(char c)
+{
+    return kSeparatorTable[static_cast<unsigned char>(c)];
+}
+
+qsizetype CountTokens(const char *begin, const char *end)
+{
+    // 统计“分隔符 -> 非分隔符”的跳变次数
+    qsizetype count{ 0 };
+    bool in_token{ false };
+    for (const char *p = begin; p < end; ++p) {
+        const bool separator = IsSeparator(*p);
+        count += (!separator && !in_token) ? 1 : 0;
+        in_token = !separator;
+    }
+    return count;
+}
+
+bool ParseSample(const char *begin, const char *end, double &value)
+{
+    // 与 QString::toDouble 保持一致，允许显式正号，但正号之后不能再出现符号（如 "+-1"）
+    if (begin < end && *begin == '+') {
+        ++begin;
+        if (begin < end && (*begin == '+' || *begin == '-')) {
+            return false;
+        }
+    }
+    const auto result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+bool ParseSamples(const char *begin, const char *end, QList<double> &samples, QByteArray *bad_token)
+{
+    samples.reserve(samples.size() + CountTokens(begin, end));
+    const char *p = begin;
+    while (p < end) {
+        while (p < end && IsSeparator(*p)) {
+            ++p;
+        }
+        const char *token_start = p;
+        while (p < end && !IsSeparator(*p)) {
+            ++p;
+        }
+        if (token_start == p) {
+            break;
+        }
+        double value{ 0.0 };
+        if (!ParseSample(token_start, p, value)) {
+            if (bad_token) {
+                *bad_token = QByteArray(token_start, p - token_start);
+            }
+            return false;
+        }
+        samples.append(value);
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,21 @@
+﻿#pragma once
+
+#include <QList>
+#include <QByteArray>
+
+// 空白分隔的采样文本解析：直接在 UTF-8 字节上用 std::from_chars 解析，
+// 不经过 QString/QStringList，也不为每个数值分配内存
+namespace SampleParser {
+
+// 跳过开头的 UTF-8 BOM（EF BB BF），与 QTextStream 读取文本时的行为一致
+const char *SkipUtf8Bom(const char *begin, const char *end);
+// 空格、制表符、换行等任意空白均视为分隔符
+bool IsSeparator(char c);
+// 统计数值个数，用于一次性预分配输出缓冲
+qsizetype CountTokens(const char *begin, const char *end);
+// 解析单个数值，要求整个区间都是合法数字
+bool ParseSample(const char *begin, const char *end, double &value);
+// 解析整段文本并追加到 samples，失败时 bad_token 返回出错的数值文本
+bool ParseSamples(const char *begin, const char *end, QList<double> &samples, QByteArray *bad_token = nullptr);
+
+}
@@ -0,0 +1,32 @@
+﻿#pragma once
+
+#include <QtGlobal>
+
+// 会话协议：同一连接上连续或交错传输多个文件。
+// 所有帧以大端 QDataStream（Qt_6_0）编码，帧头为 magic(quint32) + type(quint8) + file_id(quint32)：
+//   kFileBegin : QString 文件名, qint64 文件大小
+//   kFileData  : quint32 负载长度, quint32 负载 CRC32C, 随后为负载原始字节
+//   kFileEnd   : quint32 整个文件的 CRC32C
+//   kFileResume: QString 文件名, qint64 文件大小, quint64 内容标识（同一文件重传时须保持不变）
+//   kResumeOffset（接收端 -> 发送端）: qint64 续传偏移
+// 发送端以 kFileResume 代替 kFileBegin 开始可续传的文件，接收端回复 kResumeOffset，
+// 发送端从该偏移起继续发送 kFileData；连接中断后重新连接并再次发送 kFileResume 即可续传
+// 不以 kMagic 开头的数据按旧协议解析：QString 文件名 + qint64 文件大小 + 文件内容
+namespace SessionProtocol {
+
+constexpr quint32 kMagic{ 0x53524653 };  // "SRFS"
+constexpr qint64 kMagicSize{ 4 };
+// 旧协议传输在内部使用的文件 ID，发送端不得使用
+constexpr quint32 kLegacyFileId{ 0xFFFFFFFF };
+// 单个数据帧负载上限，超出视为协议错误
+constexpr quint32 kMaxFramePayload{ 64 * 1024 * 1024 };
+
+enum FrameType : quint8 {
+    kFileBegin = 1,
+    kFileData = 2,
+    kFileEnd = 3,
+    kFileResume = 4,
+    kResumeOffset = 5
+};
+
+}
@@ -0,0 +1,317 @@
+﻿#include "streamdemodulator.h"
+#include "txtmodel.h"
+#include "sampleparser.h"
+#include "metrics.h"
+
+using SampleParser::IsSeparator;
+
+StreamDemodulator::StreamDemodulator(QObject *parent)
+    : QObject(parent)
+{}
+
+StreamDemodulator::~StreamDemodulator()
+{}
+
+bool StreamDemodulator::Start(const QString &demodulate_t, const QString &decode_t, const ModemParams &params)
+{
+    Reset();
+    // 先确定解调方式，ApplyModemParams 按其重置同步解调状态
+    if (demodulate_t.compare("ASK", Qt::CaseInsensitive) == 0) {
+        scheme_ = kAsk;
+    } else if (demodulate_t.compare("PSK", Qt::CaseInsensitive) == 0) {
+        scheme_ = kPsk;
+    } else {
+        return false;
+    }
+    if (!ApplyModemParams(params)) {
+        scheme_ = kNone;
+        return false;
+    }
+    // 解码器自身保存跨字节的多字节字符状态
+    if (decode_t.compare("UTF-16", Qt::CaseInsensitive) == 0) {
+        text_decoder_ = QStringDecoder(QStringDecoder::Utf16);
+    } else {
+        text_decoder_ = QStringDecoder(QStringDecoder::Utf8);
+    }
+    publish_timer_.start();
+    return true;
+}
+
+bool StreamDemodulator::ApplyModemParams(const ModemParams &params)
+{
+    if (!params.Validate()) {
+        return false;
+    }
+    if (params != modem_params_ || psk_reference_.isEmpty()) {
+        modem_params_ = params;
+        psk_reference_ = modem_params_.CarrierReference();
+    }
+    pending_samples_.reserve(modem_params_.samples_per_bit);
+    if (modem_params_.symbol_sync) {
+        symbol_sync_.Reset(scheme_ == kAsk ? SymbolSync::kAsk : SymbolSync::kPsk, modem_params_);
+    }
+    return true;
+}
+
+void StreamDemodulator::Feed(const char *data, qint64 size)
+{
+    if (!IsActive() || size <= 0) {
+        return;
+    }
+    if (payload_format_ == kUnknownFormat) {
+        // 缓存负载开头，根据前 4 字节区分二进制容器和文本格式
+        const auto needed = (header_bytes_.size() < 4 ? 4 : SampleContainer::kHeaderSize) - header_bytes_.size();
+        const auto taken = qMin<qint64>(needed, size);
+        header_bytes_.append(data, taken);
+        data += taken;
+        size -= taken;
+        if (header_bytes_.size() < 4) {
+            return;
+        }
+        if (!SampleContainer::HasMagic(header_bytes_.constData(), header_bytes_.size())) {
+            payload_format_ = kTextFormat;
+            FeedTextStart();
+        } else if (header_bytes_.size() < SampleContainer::kHeaderSize) {
+            Feed(data, size);
+            return;
+        } else if (SampleContainer::ReadHeader(header_bytes_.constData(), header_bytes_.size(), sample_header_)
+                   && ApplyModemParams(ModemParams::FromHeader(sample_header_, modem_params_))) {
+            payload_format_ = kBinaryFormat;
+            header_bytes_.clear();
+        } else {
+            // 无法识别的容器头或调制参数无效，停止解调
+            Fail("采样容器头无效或调制参数无效");
+            return;
+        }
+    }
+    if (payload_format_ == kTextFormat) {
+        FeedText(data, size);
+    } else {
+        FeedBinary(data, size);
+    }
+    // 文本中出现无法解析的数值时已停止
+    if (!IsActive()) {
+        return;
+    }
+    DemodulateSamples(false);
+    Publish(false);
+}
+
+void StreamDemodulator::FeedText(const char *data, qint64 size)
+{
+    // 负载开头已出现无效数值时不再继续解析
+    if (!IsActive()) {
+        return;
+    }
+    Metrics::ScopedTimer timer(Metrics::kParse, size);
+    const char *end = data + size;
+    const char *token_begin = data;
+    // 补全上一个数据包末尾被截断的数值
+    if (!token_carry_.isEmpty()) {
+        while (token_begin < end && !IsSeparator(*token_begin)) {
+            ++token_begin;
+        }
+        token_carry_.append(data, token_begin - data);
+        if (token_begin == end) {
+            return;
+        }
+        if (!AppendToken(token_carry_.constData(), token_carry_.constData() + token_carry_.size())) {
+            return;
+        }
+        token_carry_.clear();
+    }
+    // 按空白字符切分数值
+    const char *p = token_begin;
+    while (p < end) {
+        while (p < end && IsSeparator(*p)) {
+            ++p;
+        }
+        const char *token_start = p;
+        while (p < end && !IsSeparator(*p)) {
+            ++p;
+        }
+        if (token_start == p) {
+            break;
+        }
+        if (p == end) {
+            // 数值可能被截断，留待下一个数据包
+            token_carry_.append(token_start, p - token_start);
+            break;
+        }
+        if (!AppendToken(token_start, p)) {
+            return;
+        }
+    }
+}
+
+void StreamDemodulator::FeedTextStart()
+{
+    // 文本负载开头缓存在 header_bytes_ 中，跳过可能的 UTF-8 BOM 后再解析
+    const auto *end = header_bytes_.constData() + header_bytes_.size();
+    const auto *begin = SampleParser::SkipUtf8Bom(header_bytes_.constData(), end);
+    FeedText(begin, end - begin);
+    header_bytes_.clear();
+}
+
+void StreamDemodulator::FeedBinary(const char *data, qint64 size)
+{
+    Metrics::ScopedTimer timer(Metrics::kParse, size);
+    const auto sample_size = SampleContainer::SampleSize(sample_header_.sample_type);
+    // 补全上一个数据包末尾被截断的采样
+    if (!token_carry_.isEmpty()) {
+        const auto taken = qMin<qint64>(sample_size - token_carry_.size(), size);
+        token_carry_.append(data, taken);
+        data += taken;
+        size -= taken;
+        if (token_carry_.size() < sample_size) {
+            return;
+        }
+        AppendBinarySamples(token_carry_.constData(), 1);
+        token_carry_.clear();
+    }
+    const auto count = size / sample_size;
+    AppendBinarySamples(data, count);
+    token_carry_.append(data + count * sample_size, size - count * sample_size);
+}
+
+void StreamDemodulator::AppendBinarySamples(const char *data, qint64 count)
+{
+    // 超出容器头声明的采样数的尾部数据忽略
+    count = qMin<qint64>(count, sample_header_.sample_count - binary_samples_seen_);
+    if (count <= 0) {
+        return;
+    }
+    binary_samples_seen_ += count;
+    const auto old_size = pending_samples_.size();
+    pending_samples_.resize(old_size + count);
+    SampleContainer::ConvertToDouble(data, sample_header_.sample_type, count, pending_samples_.data() + old_size);
+}
+
+void StreamDemodulator::Finish()
+{
+    if (!IsActive()) {
+        return;
+    }
+    if (payload_format_ == kUnknownFormat && !header_bytes_.isEmpty()) {
+        // 负载不足 4 字节，只可能是文本
+        payload_format_ = kTextFormat;
+        FeedTextStart();
+    }
+    if (payload_format_ == kTextFormat && !token_carry_.isEmpty()) {
+        AppendToken(token_carry_.constData(), token_carry_.constData() + token_carry_.size());
+    }
+    token_carry_.clear();
+    if (!IsActive()) {
+        return;
+    }
+    // 末尾不完整的比特与 TxtModel 的整文件解调保持一致，同样参与判决
+    DemodulateSamples(true);
+    Publish(true);
+    scheme_ = kNone;
+}
+
+void StreamDemodulator::Reset()
+{
+    scheme_ = kNone;
+    text_decoder_ = QStringDecoder();
+    payload_format_ = kUnknownFormat;
+    header_bytes_.clear();
+    sample_header_ = SampleContainer::Header();
+    binary_samples_seen_ = 0;
+    token_carry_.clear();
+    pending_samples_.clear();
+    new_bits_.Clear();
+    new_bytes_.clear();
+    current_byte_ = 0;
+    current_bit_index_ = 0;
+    bit_count_ = 0;
+    publish_timer_.invalidate();
+}
+
+bool StreamDemodulator::AppendToken(const char *begin, const char *end)
+{
+    // 丢弃无法解析的数值会使此后的比特边界整体错位，直接停止解调
+    double value{ 0.0 };
+    if (!SampleParser::ParseSample(begin, end, value)) {
+        Fail(QString("流式数据中的采样无效: %1").arg(QString::fromUtf8(begin, end - begin)));
+        return false;
+    }
+    pending_samples_.append(value);
+    return true;
+}
+
+void StreamDemodulator::Fail(const QString &message)
+{
+    scheme_ = kNone;
+    token_carry_.clear();
+    pending_samples_.clear();
+    emit demodulationError(message);
+}
+
+void StreamDemodulator::DemodulateSamples(bool flush)
+{
+    Metrics::ScopedTimer timer(Metrics::kDemodulate);
+    const auto bits_before = bit_count_;
+    qsizetype offset{ 0 };
+    if (modem_params_.symbol_sync) {
+        // 同步解调逐采样增量处理，自身保留跨数据包的比特窗口与环路状态，采样无需滞留
+        sync_bits_.Clear();
+        symbol_sync_.Process(pending_samples_.constData(), pending_samples_.size(), sync_bits_);
+        if (flush) {
+            symbol_sync_.Flush(sync_bits_);
+        }
+        for (qsizetype i{ 0 }; i < sync_bits_.size(); ++i) {
+            AppendBit(sync_bits_.Bit(i));
+        }
+        offset = pending_samples_.size();
+    }
+    const auto samples_per_bit = modem_params_.samples_per_bit;
+    const auto threshold = modem_params_.AskThreshold();
+    while (pending_samples_.size() - offset >= samples_per_bit
+           || (flush && pending_samples_.size() > offset)) {
+        const auto count = qMin(samples_per_bit, pending_samples_.size() - offset);
+        const auto *samples = pending_samples_.constData() + offset;
+        const auto bit = scheme_ == kAsk ? TxtModel::DemodulateAskBit(samples, count, threshold)
+                                         : TxtModel::DemodulatePskBit(samples, count, psk_reference_.constData());
+        offset += count;
+        AppendBit(bit);
+    }
+    pending_samples_.remove(0, offset);
+    timer.set_bytes(offset * sizeof(double));
+    timer.set_items(bit_count_ - bits_before);
+}
+
+void StreamDemodulator::AppendBit(uint8_t bit)
+{
+    new_bits_.AppendBit(bit);
+    ++bit_count_;
+    // 高位在前组装字节
+    current_byte_ |= bit << (7 - current_bit_index_);
+    if (++current_bit_index_ == 8) {
+        new_bytes_.append(static_cast<char>(current_byte_));
+        current_byte_ = 0;
+        current_bit_index_ = 0;
+    }
+}
+
+void StreamDemodulator::Publish(bool force)
+{
+    // 未到发布间隔时继续累积，减少发往 UI 线程的排队信号
+    if (!force && publish_timer_.isValid() && publish_timer_.elapsed() < kPublishIntervalMs) {
+        return;
+    }
+    publish_timer_.restart();
+    if (!new_bits_.isEmpty()) {
+        emit bitsDemodulated(new_bits_);
+        new_bits_.Clear();
+    }
+    if (!new_bytes_.isEmpty()) {
+        Metrics::ScopedTimer timer(Metrics::kDecode, new_bytes_.size());
+        const QString text = text_decoder_.decode(new_bytes_);
+        timer.set_items(text.size());
+        new_bytes_.clear();
+        if (!text.isEmpty()) {
+            emit textDecoded(text);
+        }
+    }
+}
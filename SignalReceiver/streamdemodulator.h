@@ -0,0 +1,85 @@
+﻿#pragma once
+
+#include <QObject>
+#include <QList>
+#include <QByteArray>
+#include <QStringDecoder>
+#include <QElapsedTimer>
+#include "samplecontainer.h"
+#include "bitstream.h"
+#include "modemparams.h"
+#include "symbolsync.h"
+
+// 流式解调器：网络数据到达时即增量解析采样值、解调比特并解码字符，
+// 无需等待整个文件落盘后再由 TxtModel 重新读取。
+// 负载可以是空白分隔的采样文本，也可以是 SampleContainer 二进制容器
+class StreamDemodulator : public QObject
+{
+    Q_OBJECT
+
+public:
+    StreamDemodulator(QObject *parent);
+    ~StreamDemodulator();
+
+    // 文本负载按 params 解调；二进制容器改用其文件头中的参数
+    bool Start(const QString &demodulate_t, const QString &decode_t, const ModemParams &params = ModemParams());
+    void Feed(const char *data, qint64 size);
+    void Finish();
+    void Reset();
+
+    bool IsActive() const { return scheme_ != kNone; }
+    qint64 get_bit_count() const { return bit_count_; }
+
+signals:
+    void bitsDemodulated(const BitStream &bits);
+    void textDecoded(const QString &text);
+    // 负载无法解析时停止解调并报告原因，与 TxtModel 加载同一文件时的拒绝保持一致
+    void demodulationError(const QString &message);
+
+private:
+    enum Scheme {
+        kNone,
+        kAsk,
+        kPsk
+    };
+
+    enum PayloadFormat {
+        kUnknownFormat,
+        kTextFormat,
+        kBinaryFormat
+    };
+
+    void FeedTextStart();
+    void FeedText(const char *data, qint64 size);
+    void FeedBinary(const char *data, qint64 size);
+    bool AppendToken(const char *begin, const char *end);
+    void AppendBinarySamples(const char *data, qint64 count);
+    void DemodulateSamples(bool flush);
+    void AppendBit(uint8_t bit);
+    void Publish(bool force);
+    bool ApplyModemParams(const ModemParams &params);
+    void Fail(const QString &message);
+
+private:
+    Scheme scheme_{ kNone };
+    ModemParams modem_params_;
+    QList<double> psk_reference_;
+    QStringDecoder text_decoder_;
+
+    PayloadFormat payload_format_{ kUnknownFormat };
+    QByteArray header_bytes_;           // 尚未凑齐的负载开头（格式识别/容器头）
+    SampleContainer::Header sample_header_;
+    quint64 binary_samples_seen_{ 0 };
+    QByteArray token_carry_;            // 跨数据包被截断的数值文本或二进制采样
+    QList<double> pending_samples_;     // 尚未凑满一个比特的采样
+    SymbolSync symbol_sync_;            // 调制参数启用同步解调时使用
+    BitStream sync_bits_;               // 同步解调本次输出的比特
+    BitStream new_bits_;                // 本次 Feed 新解调出的比特
+    QByteArray new_bytes_;              // 本次 Feed 新组装出的字节
+    uint8_t current_byte_{ 0 };
+    int current_bit_index_{ 0 };
+    qint64 bit_count_{ 0 };
+    // 结果合并：跨线程发出的结果信号之间至少间隔 kPublishIntervalMs
+    QElapsedTimer publish_timer_;
+    static constexpr qint64 kPublishIntervalMs{ 50 };
+};
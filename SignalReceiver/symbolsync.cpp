@@ -0,0 +1,458 @@
+﻿#include "symbolsync.h"
+#include <QtMath>
+#include <cmath>
+
+namespace {
+
+// 环路增益按每比特更新一次设计：比例项决定收敛速度，积分项跟踪持续的频率/时钟偏差。
+// 捕获阶段使用较大的增益，稳定后换用较小的增益降低抖动：
+// 两个环路都在找到前导码且各自的锁定指示稳定后才换用窄带（滞回，指示变差时退回宽带）
+constexpr double kCarrierProportional[2]{ 0.1, 0.2 };
+constexpr double kCarrierIntegral[2]{ 0.005, 0.02 };
+constexpr double kFrequencyDetector{ 0.2 };
+constexpr double kCarrierLockSmoothing{ 0.05 };
+constexpr double kCarrierLockEnter{ 0.7 };
+constexpr double kCarrierLockLeave{ 0.3 };
+// 锁定时以前导码末尾的这些比特确定 PSK 极性，此时载波环路已基本收敛，
+// 前导码前段即使发生过跳周也不影响此后的判决
+constexpr qsizetype kPolarityBits{ 8 };
+// 相关值超过阈值后再观察的比特数，取其中相关最高的位置作为前导码结尾，
+// 避免重复图样（如 0x55）在错开一两个比特时提前达到阈值造成帧错位
+constexpr qsizetype kPeakSearchBits{ 4 };
+constexpr double kTimingProportional[2]{ 0.15, 0.25 };
+constexpr double kTimingIntegral[2]{ 0.005, 0.01 };
+constexpr double kTimingJitterSmoothing{ 0.05 };
+constexpr double kTimingSettleEnter{ 0.05 };
+constexpr double kTimingSettleLeave{ 0.2 };
+// 时钟偏差跟踪范围与单个比特长度的调整范围（相对标称比特长度）
+constexpr double kMaxClockOffset{ 0.05 };
+constexpr double kMaxPeriodAdjust{ 0.25 };
+// 捕获阶段判断比特窗口错开半个比特的能量对比平滑系数与阈值
+constexpr double kHalfBitSmoothing{ 0.2 };
+constexpr double kHalfBitThreshold{ 0.8 };
+// 归一化功率与 ASK 中心电平的平滑系数，中心电平同样在找到前导码前使用较快的平滑
+constexpr double kPowerSmoothing{ 0.05 };
+constexpr double kLevelSmoothing[2]{ 0.02, 0.1 };
+
+}
+
+void SymbolSync::Reset(Scheme scheme, const ModemParams &params)
+{
+    scheme_ = scheme;
+    nominal_period_ = static_cast<double>(params.samples_per_bit);
+    sample_rate_ = params.sample_rate;
+    carrier_step_ = 2 * M_PI * params.carrier_freq / params.sample_rate;
+
+    sample_index_ = 0;
+    previous_product_[0] = previous_product_[1] = 0.0;
+    carrier_phase_ = 0.0;
+    symbol_first_sample_ = 0;
+    frequency_offset_ = 0.0;
+    previous_symbol_[0] = previous_symbol_[1] = 0.0;
+    carrier_lock_ = 0.0;
+    carrier_settled_ = false;
+    period_offset_ = 0.0;
+    previous_value_[0] = previous_value_[1] = 0.0;
+    previous_half_[0] = previous_half_[1] = 0.0;
+    has_previous_ = false;
+    power_ = 0.0;
+    half_bit_contrast_ = 0.0;
+    timing_jitter_ = 1.0;
+    timing_settled_ = false;
+    ask_level_ = 0.0;
+
+    // 前导码按高位在前展开为 ±1 序列
+    preamble_.clear();
+    for (const char byte : params.preamble) {
+        for (int bit{ 7 }; bit >= 0; --bit) {
+            preamble_.append(((static_cast<uint8_t>(byte) >> bit) & 1) ? 1.0 : -1.0);
+        }
+    }
+    history_.fill(Symbol(), preamble_.size());
+    history_pos_ = 0;
+    history_count_ = 0;
+    locked_ = preamble_.isEmpty();
+    inverted_ = false;
+    best_correlation_ = 0.0;
+    best_inverted_ = false;
+    bits_after_best_ = 0;
+    lock_floor_ = 0.0;
+    lock_amplitude_ = 0.0;
+    carrier_absent_bits_ = 0;
+
+    StartSymbol(0.0, nominal_period_, 0);
+}
+
+qsizetype SymbolSync::Process(const double *samples, qsizetype count, BitStream &bits)
+{
+    qsizetype produced{ 0 };
+    for (qsizetype i{ 0 }; i < count; ++i) {
+        const double x = samples[i];
+        const qint64 n = sample_index_++;
+        // 比特窗口包含起点不小于、终点小于窗口边界的整数采样，边界的小数部分随时钟跟踪累积
+        if (n >= symbol_end_) {
+            FinishSymbol(n, bits, produced);
+        } else if (half_ == 0 && n >= symbol_mid_) {
+            half_ = 1;
+        }
+        // ASK 累加相邻两个采样的乘积：每比特采样较少时半比特只含一两个载波周期，窗口边界随时钟跟踪移动，
+        // 乘积中的二倍频分量在窗口内不能抵消，包络随载波相位起伏；两点求和在载波为采样率 1/4 时将其完全消除
+        const double product[2]{ x * ref_sin_, x * ref_cos_ };
+        if (scheme_ == kAsk) {
+            in_phase_[half_] += product[0] + previous_product_[0];
+            quadrature_[half_] += product[1] + previous_product_[1];
+            previous_product_[0] = product[0];
+            previous_product_[1] = product[1];
+        } else {
+            in_phase_[half_] += product[0];
+            quadrature_[half_] += product[1];
+        }
+        // 参考相量旋转一个采样
+        const double next_sin = ref_sin_ * rotate_cos_ + ref_cos_ * rotate_sin_;
+        ref_cos_ = ref_cos_ * rotate_cos_ - ref_sin_ * rotate_sin_;
+        ref_sin_ = next_sin;
+    }
+    return produced;
+}
+
+qsizetype SymbolSync::Flush(BitStream &bits)
+{
+    // 数据结束时，末尾不完整的比特已超过半个比特长度才作判决
+    qsizetype produced{ 0 };
+    if (sample_index_ > symbol_mid_) {
+        FinishSymbol(sample_index_, bits, produced);
+    }
+    return produced;
+}
+
+double SymbolSync::CarrierOffsetHz() const
+{
+    return frequency_offset_ * sample_rate_ / (2 * M_PI);
+}
+
+void SymbolSync::FinishSymbol(qint64 sample_index, BitStream &bits, qsizetype &produced)
+{
+    const double in_phase = in_phase_[0] + in_phase_[1];
+    const double quadrature = quadrature_[0] + quadrature_[1];
+    // 参考载波相位推进到下一个比特的首个采样
+    carrier_phase_ += carrier_step_used_ * (sample_index - symbol_first_sample_);
+
+    // 定时误差所用的前后半比特值：PSK 取同相与正交两路（与载波相位无关）；
+    // ASK 取包络减去中心电平，中心电平为包络的滑动平均
+    const int gear = locked_ ? 0 : 1;
+    double first_half[2]{ in_phase_[0], quadrature_[0] };
+    double second_half[2]{ in_phase_[1], quadrature_[1] };
+    double envelope{ 0.0 };
+    if (scheme_ == kAsk) {
+        const double envelope0 = std::hypot(in_phase_[0], quadrature_[0]);
+        const double envelope1 = std::hypot(in_phase_[1], quadrature_[1]);
+        envelope = envelope0 + envelope1;
+        ask_level_ = has_previous_ ? ask_level_ + kLevelSmoothing[gear] * (envelope - ask_level_) : envelope;
+        first_half[0] = envelope0 - ask_level_ / 2;
+        second_half[0] = envelope1 - ask_level_ / 2;
+        first_half[1] = second_half[1] = 0.0;
+    }
+    const double value[2]{ first_half[0] + second_half[0], first_half[1] + second_half[1] };
+    const double value_power = value[0] * value[0] + value[1] * value[1];
+    power_ = has_previous_ ? power_ + kPowerSmoothing * (value_power - power_) : value_power;
+
+    // Gardner：跨上一个边界的中点值与前后两个比特值之差的内积，比特窗口滞后时为负
+    // 中点值减去前后两个比特值的均值，消除中心电平尚未收敛（ASK 捕获阶段）带来的直流偏置。
+    // 窗口错开半个比特时交替的比特（如前导码中的 0x55）各含半个 1 与半个 0，误差也趋于 0，
+    // 环路会停滞在此处。捕获阶段比较中点偏离与比特值变化的能量，前者持续明显更大时直接跳过半个比特
+    double timing_error{ 0.0 };
+    bool skip_half_bit{ false };
+    if (has_previous_ && power_ > 0.0) {
+        double error{ 0.0 };
+        double middle_power{ 0.0 };
+        double change_power{ 0.0 };
+        for (int c{ 0 }; c < 2; ++c) {
+            const double middle = previous_half_[c] + first_half[c] - (previous_value_[c] + value[c]) / 2;
+            const double change = previous_value_[c] - value[c];
+            error += middle * change;
+            middle_power += middle * middle;
+            change_power += change * change / 4;
+        }
+        timing_error = qBound(-2.0, error / power_, 2.0);
+        // 定时锁定指示：比特值没有变化时误差恒为 0，只在有明显变化的比特处累计
+        if (change_power > power_ / 2) {
+            timing_jitter_ += kTimingJitterSmoothing * (timing_error * timing_error - timing_jitter_);
+            if (!timing_settled_ && locked_ && timing_jitter_ < kTimingSettleEnter) {
+                timing_settled_ = true;
+            } else if (timing_settled_ && timing_jitter_ > kTimingSettleLeave) {
+                timing_settled_ = false;
+            }
+        }
+        if (!locked_ && middle_power + change_power > 0.0) {
+            half_bit_contrast_ += kHalfBitSmoothing
+                                  * ((middle_power - change_power) / (middle_power + change_power) - half_bit_contrast_);
+            if (half_bit_contrast_ > kHalfBitThreshold) {
+                half_bit_contrast_ = 0.0;
+                skip_half_bit = true;
+            }
+        }
+    }
+    // 误差约为 -4 * 滞后量 / 比特长度，换算为采样数后调整下一个比特的长度
+    const int timing_gear = timing_settled_ ? 0 : 1;
+    const double timing_adjust = timing_error * nominal_period_ / 4;
+    period_offset_ = qBound(-kMaxClockOffset * nominal_period_,
+                            period_offset_ + kTimingIntegral[timing_gear] * timing_adjust,
+                            kMaxClockOffset * nominal_period_);
+    const double period = nominal_period_ + period_offset_
+                          + qBound(-kMaxPeriodAdjust * nominal_period_,
+                                   kTimingProportional[timing_gear] * timing_adjust,
+                                   kMaxPeriodAdjust * nominal_period_);
+    for (int c{ 0 }; c < 2; ++c) {
+        previous_value_[c] = value[c];
+        previous_half_[c] = second_half[c];
+    }
+    has_previous_ = true;
+
+    if (scheme_ == kPsk) {
+        UpdateCarrier(in_phase, quadrature);
+    }
+
+    // 软判决以正值表示比特 1：PSK 为反相相关，ASK 为包络高于中心电平的部分。
+    // 与前导码相关，锁定后才输出比特；锁定后 PSK 仍检查再次出现的前导码以纠正极性，
+    // 载波持续消失时回到搜索
+    const Symbol symbol = scheme_ == kPsk ? Symbol{ -in_phase, in_phase, quadrature } : Symbol{ value[0], envelope, 0.0 };
+    if (locked_) {
+        if (scheme_ == kPsk && PushHistory(symbol)) {
+            CheckPolarity();
+        }
+        AppendBit(symbol, bits, produced);
+        UpdateLossOfLock(symbol);
+    } else {
+        SearchPreamble(symbol, bits, produced);
+    }
+
+    // 跳过半个比特：下一个比特窗口加长半个比特，其值在捕获阶段丢弃影响不大
+    StartSymbol(symbol_end_, skip_half_bit ? period * 1.5 : period, sample_index);
+}
+
+void SymbolSync::StartSymbol(double start, double period, qint64 sample_index)
+{
+    symbol_mid_ = start + period / 2;
+    symbol_end_ = start + period;
+    half_ = 0;
+    in_phase_[0] = in_phase_[1] = 0.0;
+    quadrature_[0] = quadrature_[1] = 0.0;
+    // 参考载波连续振荡，每个比特开始时由累积相位重新计算相量，避免逐采样旋转的误差累积
+    if (carrier_phase_ > M_PI || carrier_phase_ < -M_PI) {
+        carrier_phase_ = std::remainder(carrier_phase_, 2 * M_PI);
+    }
+    carrier_step_used_ = carrier_step_ + frequency_offset_;
+    symbol_first_sample_ = sample_index;
+    ref_sin_ = std::sin(carrier_phase_);
+    ref_cos_ = std::cos(carrier_phase_);
+    rotate_sin_ = std::sin(carrier_step_used_);
+    rotate_cos_ = std::cos(carrier_step_used_);
+}
+
+void SymbolSync::UpdateCarrier(double in_phase, double quadrature)
+{
+    if (in_phase == 0.0 && quadrature == 0.0) {
+        return;
+    }
+    const int gear = carrier_settled_ ? 0 : 1;
+    // 判决引导的相位误差，去除 PSK 调制符号的影响
+    const double phase_error = std::atan2(in_phase < 0 ? -quadrature : quadrature, std::abs(in_phase));
+    // 捕获阶段的频率误差：相邻比特相关值之积的平方与调制无关，其辐角的一半即每比特的残余相位旋转，
+    // 在 ±1/4 比特率内无模糊，不依赖相位环路是否已锁定。稳定后由相位环路的积分项单独跟踪
+    if (!carrier_settled_ && (previous_symbol_[0] != 0.0 || previous_symbol_[1] != 0.0)) {
+        const double real = in_phase * previous_symbol_[0] + quadrature * previous_symbol_[1];
+        const double imag = quadrature * previous_symbol_[0] - in_phase * previous_symbol_[1];
+        const double frequency_error = std::atan2(2 * real * imag, real * real - imag * imag) / 2;
+        frequency_offset_ += kFrequencyDetector * frequency_error / nominal_period_;
+    }
+    previous_symbol_[0] = in_phase;
+    previous_symbol_[1] = quadrature;
+    carrier_phase_ += kCarrierProportional[gear] * phase_error;
+    frequency_offset_ += kCarrierIntegral[gear] * phase_error / nominal_period_;
+    // 频率修正限制在频率误差估计的无模糊范围内，避免前导码之前的噪声使其漂移
+    const double max_offset = M_PI / 2 / nominal_period_;
+    frequency_offset_ = qBound(-max_offset, frequency_offset_, max_offset);
+
+    // 锁定指示：相位误差稳定在 0 附近时 cos(2 * 误差) 的均值接近 1。
+    // 找到前导码且指示足够高后换用窄带增益，指示下降时退回宽带重新捕获
+    const double lock = (in_phase * in_phase - quadrature * quadrature) / (in_phase * in_phase + quadrature * quadrature);
+    carrier_lock_ += kCarrierLockSmoothing * (lock - carrier_lock_);
+    if (!carrier_settled_ && locked_ && carrier_lock_ > kCarrierLockEnter) {
+        carrier_settled_ = true;
+    } else if (carrier_settled_ && carrier_lock_ < kCarrierLockLeave) {
+        carrier_settled_ = false;
+    }
+}
+
+bool SymbolSync::PushHistory(const Symbol &symbol)
+{
+    const qsizetype length = preamble_.size();
+    if (length == 0) {
+        return false;
+    }
+    history_[history_pos_] = symbol;
+    if (++history_pos_ == length) {
+        history_pos_ = 0;
+    }
+    if (history_count_ < length) {
+        ++history_count_;
+    }
+    return history_count_ == length;
+}
+
+void SymbolSync::CheckPolarity()
+{
+    // 最近的比特逐个与前导码一致或逐个与其反码一致时重新确定极性；
+    // 要求全部比特一致，数据中偶然出现的相近序列不会误翻转。多数位置在前几个比特即可排除
+    const qsizetype length = preamble_.size();
+    qsizetype index = history_pos_;
+    const bool inverted = (history_[index].soft > 0) != (preamble_[0] > 0);
+    for (qsizetype i{ 1 }; i < length; ++i) {
+        if (++index == length) {
+            index = 0;
+        }
+        if (((history_[index].soft > 0) != (preamble_[i] > 0)) != inverted) {
+            return;
+        }
+    }
+    inverted_ = inverted;
+}
+
+void SymbolSync::AppendBit(const Symbol &symbol, BitStream &bits, qsizetype &produced)
+{
+    // ASK 按包络与当前中心电平判决，锁定时补发的比特因此使用由前导码设定的电平
+    bits.AppendBit(scheme_ == kPsk ? ((symbol.soft > 0) != inverted_) : symbol.in_phase > ask_level_);
+    ++produced;
+}
+
+void SymbolSync::MeasureLockLevels()
+{
+    // history_pos_ 此时指向最早的一个比特，窗口与前导码对齐
+    const qsizetype length = preamble_.size();
+    const auto at = [this, length](qsizetype i) -> const Symbol & { return history_[(history_pos_ + i) % length]; };
+    if (scheme_ == kPsk) {
+        double amplitude{ 0.0 };
+        for (qsizetype i{ 0 }; i < length; ++i) {
+            amplitude += std::hypot(at(i).in_phase, at(i).quadrature);
+        }
+        lock_floor_ = 0.0;
+        lock_amplitude_ = amplitude / length;
+        return;
+    }
+    // ASK：前导码中 1 与 0 比特的平均包络
+    double level[2]{ 0.0, 0.0 };
+    qsizetype count[2]{ 0, 0 };
+    for (qsizetype i{ 0 }; i < length; ++i) {
+        const int bit = preamble_[i] > 0 ? 1 : 0;
+        level[bit] += at(i).in_phase;
+        ++count[bit];
+    }
+    lock_floor_ = count[0] > 0 ? level[0] / count[0] : 0.0;
+    lock_amplitude_ = count[1] > 0 ? level[1] / count[1] - lock_floor_ : 0.0;
+}
+
+void SymbolSync::UpdateLossOfLock(const Symbol &symbol)
+{
+    if (preamble_.isEmpty()) {
+        return;
+    }
+    // ASK 的无载波比特与连续的 0 无法区分，kLossOfLockBits 取得足够长，正常数据中不会出现
+    const double magnitude = scheme_ == kAsk ? symbol.in_phase : std::hypot(symbol.in_phase, symbol.quadrature);
+    carrier_absent_bits_ = magnitude - lock_floor_ < lock_amplitude_ / 2 ? carrier_absent_bits_ + 1 : 0;
+    if (carrier_absent_bits_ >= kLossOfLockBits) {
+        LoseLock();
+    }
+}
+
+void SymbolSync::LoseLock()
+{
+    // 定时与载波环路保持当前的偏差估计，退回宽带增益并重新搜索前导码
+    locked_ = false;
+    inverted_ = false;
+    carrier_settled_ = false;
+    timing_settled_ = false;
+    history_pos_ = 0;
+    history_count_ = 0;
+    best_correlation_ = 0.0;
+    best_inverted_ = false;
+    bits_after_best_ = 0;
+    carrier_absent_bits_ = 0;
+}
+
+void SymbolSync::SearchPreamble(const Symbol &symbol, BitStream &bits, qsizetype &produced)
+{
+    if (!PushHistory(symbol)) {
+        return;
+    }
+    bool inverted{ false };
+    const double correlation = PreambleCorrelation(&inverted);
+    if (correlation >= kPreambleThreshold && correlation > best_correlation_) {
+        best_correlation_ = correlation;
+        best_inverted_ = inverted;
+        bits_after_best_ = 0;
+        MeasureLockLevels();
+    } else if (best_correlation_ > 0.0) {
+        ++bits_after_best_;
+    }
+    const qsizetype length = preamble_.size();
+    if (best_correlation_ <= 0.0 || bits_after_best_ < qMin(kPeakSearchBits, length - 1)) {
+        return;
+    }
+    // 以相关最高的位置为前导码结尾，其后已收到的比特从比较窗口中补发
+    locked_ = true;
+    inverted_ = best_inverted_;
+    carrier_absent_bits_ = 0;
+    if (scheme_ == kAsk) {
+        ask_level_ = lock_floor_ + lock_amplitude_ / 2;
+    }
+    for (qsizetype i{ length - bits_after_best_ }; i < length; ++i) {
+        AppendBit(history_[(history_pos_ + i) % length], bits, produced);
+    }
+}
+
+double SymbolSync::PreambleCorrelation(bool *inverted) const
+{
+    // history_pos_ 此时指向最早的一个比特
+    const qsizetype length = preamble_.size();
+    const auto at = [this, length](qsizetype i) -> const Symbol & { return history_[(history_pos_ + i) % length]; };
+    double correlation{ 0.0 };
+    double magnitude{ 0.0 };
+    if (scheme_ == kAsk) {
+        // 包络与前导码各自去均值后的相关系数，与中心电平及信号幅度无关
+        double envelope_mean{ 0.0 };
+        double preamble_mean{ 0.0 };
+        for (qsizetype i{ 0 }; i < length; ++i) {
+            envelope_mean += at(i).in_phase;
+            preamble_mean += preamble_[i];
+        }
+        envelope_mean /= length;
+        preamble_mean /= length;
+        double envelope_energy{ 0.0 };
+        double preamble_energy{ 0.0 };
+        for (qsizetype i{ 0 }; i < length; ++i) {
+            const double envelope = at(i).in_phase - envelope_mean;
+            const double reference = preamble_[i] - preamble_mean;
+            correlation += envelope * reference;
+            envelope_energy += envelope * envelope;
+            preamble_energy += reference * reference;
+        }
+        magnitude = std::sqrt(envelope_energy * preamble_energy);
+        return magnitude > 0.0 ? correlation / magnitude : 0.0;
+    }
+    // PSK 比较相邻比特的相位变化（差分相关），不受载波环路尚未收敛的残余相位与频偏影响
+    for (qsizetype i{ 1 }; i < length; ++i) {
+        const double product = at(i).in_phase * at(i - 1).in_phase + at(i).quadrature * at(i - 1).quadrature;
+        correlation += product * preamble_[i] * preamble_[i - 1];
+        magnitude += std::abs(product);
+    }
+    if (magnitude <= 0.0) {
+        return 0.0;
+    }
+    // 载波环路可能锁定在反相，以前导码末尾的相干相关符号确定此后的判决是否翻转
+    double coherent{ 0.0 };
+    for (qsizetype i{ qMax<qsizetype>(0, length - kPolarityBits) }; i < length; ++i) {
+        coherent += at(i).soft * preamble_[i];
+    }
+    *inverted = coherent < 0;
+    return correlation / magnitude;
+}
@@ -0,0 +1,125 @@
+﻿#pragma once
+
+#include <QtGlobal>
+#include <QList>
+#include <QByteArray>
+#include "bitstream.h"
+#include "modemparams.h"
+
+// 同步解调：不再假定第 0 个采样恰好是比特边界、载波相位与每比特重新开始的 sin(2*pi*fc*t) 对齐。
+// 逐采样增量处理，可直接用于流式数据：
+//  - 载波：参考信号为连续的本地振荡，不随比特边界重新开始，位定时的抖动不会带入载波相位。
+//    PSK 用判决引导的相位误差驱动二阶环路跟踪相位与频率，另以相邻比特相关的平方
+//    （与调制无关）估计频率误差辅助捕获；环路稳定后才换用窄带增益；
+//  - 位定时：每个比特分前后两个半比特积分，跨比特边界的两个半比特之和作为 Gardner 的中点样本，
+//    误差驱动二阶环路调整下一个比特的长度，跟踪时钟偏差。中点值去除前后比特值的均值，不受 ASK 中心电平偏置影响；
+//    捕获阶段窗口错开约半个比特（交替图样上误差趋于 0 的停滞点）时直接跳过半个比特；
+//  - 前导码：对最近的软判决与已知前导码做归一化相关，达到阈值后才开始输出比特，
+//    同时确定帧起点并消除 PSK 的 180° 相位模糊。锁定后再次出现的前导码（逐比特与前导码或其反码一致）
+//    重新确定极性，纠正载波环路跳周造成的整体反相。ASK 以去均值的包络与前导码相关，
+//    不依赖尚未收敛的中心电平，锁定时再由前导码窗口设定中心电平；
+//  - 失锁：锁定后载波连续 kLossOfLockBits 个比特低于锁定时幅度的一半，视为信号结束，
+//    回到前导码搜索，下一段信号的前导码可重新锁定。未设置前导码时立即输出，不做失锁判断
+class SymbolSync
+{
+public:
+    enum Scheme {
+        kAsk,
+        kPsk
+    };
+
+    void Reset(Scheme scheme, const ModemParams &params);
+    // 处理 count 个采样，恢复出的比特追加到 bits，返回追加的比特数
+    qsizetype Process(const double *samples, qsizetype count, BitStream &bits);
+    // 数据结束时调用，输出末尾不完整的比特
+    qsizetype Flush(BitStream &bits);
+
+    bool IsLocked() const { return locked_; }
+    // 定时环路是否已稳定，稳定后使用窄带增益
+    bool IsTimingLocked() const { return timing_settled_; }
+    // 载波环路是否已稳定（PSK），稳定后使用窄带增益
+    bool IsCarrierLocked() const { return carrier_settled_; }
+    // 当前跟踪到的时钟偏差（比特长度相对标称值的比例）与载波频率偏移（Hz）
+    double ClockOffset() const { return period_offset_ / nominal_period_; }
+    double CarrierOffsetHz() const;
+
+    // 判定前导码出现的归一化相关阈值
+    static constexpr double kPreambleThreshold{ 0.8 };
+    // 判定失锁所需的连续无载波比特数
+    static constexpr qsizetype kLossOfLockBits{ 64 };
+
+private:
+    // 一个比特的软判决与整比特相关值，供前导码检测使用；ASK 的 in_phase 为整比特包络
+    struct Symbol {
+        double soft{ 0.0 };
+        double in_phase{ 0.0 };
+        double quadrature{ 0.0 };
+    };
+
+    void FinishSymbol(qint64 sample_index, BitStream &bits, qsizetype &produced);
+    void StartSymbol(double start, double period, qint64 sample_index);
+    void UpdateCarrier(double in_phase, double quadrature);
+    void AppendBit(const Symbol &symbol, BitStream &bits, qsizetype &produced);
+    // 将比特加入前导码比较窗口，窗口已满时返回 true
+    bool PushHistory(const Symbol &symbol);
+    void SearchPreamble(const Symbol &symbol, BitStream &bits, qsizetype &produced);
+    // 比较窗口与前导码的归一化相关；PSK 同时给出极性
+    double PreambleCorrelation(bool *inverted) const;
+    void CheckPolarity();
+    // 以前导码窗口确定锁定后的 ASK 中心电平与判断失锁的参考幅度
+    void MeasureLockLevels();
+    void UpdateLossOfLock(const Symbol &symbol);
+    void LoseLock();
+
+private:
+    Scheme scheme_{ kPsk };
+    double nominal_period_{ 16.0 };
+    double sample_rate_{ 1600.0 };
+    double carrier_step_{ 0.0 };        // 标称载波每采样的相位增量
+
+    qint64 sample_index_{ 0 };          // 下一个输入采样的绝对序号
+    double symbol_mid_{ 0.0 };          // 当前比特的中点与终点（绝对采样位置，含小数）
+    double symbol_end_{ 0.0 };
+    int half_{ 0 };
+    double in_phase_[2]{ 0.0, 0.0 };    // 前后半比特与参考载波的相关（同相、正交）
+    double quadrature_[2]{ 0.0, 0.0 };
+    double previous_product_[2]{ 0.0, 0.0 }; // ASK：上一个采样与参考载波的乘积
+
+    // 参考载波相量：每个比特开始时由连续累积的载波相位重新计算，比特内逐采样旋转
+    double ref_sin_{ 0.0 };
+    double ref_cos_{ 1.0 };
+    double rotate_sin_{ 0.0 };
+    double rotate_cos_{ 1.0 };
+    double carrier_phase_{ 0.0 };       // 当前比特首个采样处的参考载波相位
+    double carrier_step_used_{ 0.0 };   // 当前比特内每采样的相位增量
+    qint64 symbol_first_sample_{ 0 };   // 当前比特首个采样的绝对序号
+    double frequency_offset_{ 0.0 };    // 载波环路：每采样的频率修正
+    double previous_symbol_[2]{ 0.0, 0.0 }; // 上一个比特的整比特相关值，供频率误差估计
+    double carrier_lock_{ 0.0 };        // cos(2 * 相位误差) 的滑动平均，接近 1 表示载波环路已稳定
+    bool carrier_settled_{ false };
+
+    // 定时环路
+    double period_offset_{ 0.0 };       // 积分项：比特长度相对标称值的偏差
+    double previous_value_[2]{ 0.0, 0.0 }; // 上一个比特的整比特值与后半比特值（两路）
+    double previous_half_[2]{ 0.0, 0.0 };
+    bool has_previous_{ false };
+    double power_{ 0.0 };               // 整比特值平方的滑动平均，用于误差归一化
+    double timing_jitter_{ 0.0 };       // 比特值变化处定时误差平方的滑动平均
+    bool timing_settled_{ false };
+    double half_bit_contrast_{ 0.0 };   // 跨边界值与整比特值的能量对比，接近 1 表示窗口错开约半个比特
+    double ask_level_{ 0.0 };           // ASK 包络的滑动平均，作为中心电平
+
+    // 前导码
+    QList<double> preamble_;            // ±1，1 对应比特 1
+    QList<Symbol> history_;             // 最近的比特，环形缓冲
+    qsizetype history_pos_{ 0 };
+    qsizetype history_count_{ 0 };
+    bool locked_{ false };
+    bool inverted_{ false };            // PSK 锁定在反相时翻转判决
+    double best_correlation_{ 0.0 };    // 超过阈值后观察期内的最高相关及其位置之后的比特数
+    bool best_inverted_{ false };
+    qsizetype bits_after_best_{ 0 };
+    double lock_floor_{ 0.0 };          // 锁定时无载波比特的幅度（ASK 的 0 电平，PSK 为 0）
+    double lock_amplitude_{ 0.0 };      // 锁定时载波比特相对 lock_floor_ 的幅度
+    qsizetype carrier_absent_bits_{ 0 };
+};
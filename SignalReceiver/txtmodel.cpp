@@ -1,111 +1,389 @@
 ﻿#include "txtmodel.h"
+#include "demodkernels.h"
+#include "sampleparser.h"
+#include "metrics.h"
+#include "sampleconvert.h"
+#include "symbolsync.h"
 #include <QFile>
-#include <QMessageBox>
+#include <QTextStream>
 
 TxtModel::TxtModel(QObject *parent)
     : QObject(parent)
-{}
+    , psk_reference_(modem_params_.CarrierReference())
+    , demod_engine_(new DemodEngine(this))
+{
+    connect(demod_engine_, &DemodEngine::progressChanged, this, &TxtModel::demodulationProgress);
+    connect(demod_engine_, &DemodEngine::finished, this, &TxtModel::onDemodulationFinished);
+    sync_pool_.setMaxThreadCount(1);
+}
 
 TxtModel::~TxtModel()
-{}
+{
+    CancelDemodulation();
+    demod_engine_->WaitForFinished();
+    sync_pool_.waitForDone();
+}
+
+bool TxtModel::set_modem_params(const ModemParams &params)
+{
+    // 解调进行中时引擎仍在读取参考信号
+    if (IsDemodulating()) {
+        error_message_ = "解调进行中，无法修改调制参数";
+        return false;
+    }
+    if (!params.Validate(&error_message_)) {
+        return false;
+    }
+    if (params != modem_params_) {
+        const bool resample = is_wav_file_ && params.sample_rate != modem_params_.sample_rate;
+        modem_params_ = params;
+        psk_reference_ = modem_params_.CarrierReference();
+        // WAV 音频加载时已按原采样率重采样，采样率变化后必须重新转换，否则比特长度与载波都对不上。
+        // 旧缓冲保留到通知发出之后，视图在此之前仍可安全读取
+        if (resample) {
+            QList<double> previous_samples;
+            previous_samples.swap(txt_modulated_data_);
+            ConvertWavSamples();
+            emit samplesReloaded();
+        }
+    }
+    return true;
+}
 
 bool TxtModel::LoadTxtFile(const QString &file_name)
 {
-    QFile file(file_name);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QMessageBox::warning(static_cast<QWidget *>(parent()), "Error", QString("Cannot open file: %1")
-                             .arg(file.errorString()));
+    // 解调进行中时采样缓冲不能被替换
+    if (IsDemodulating()) {
+        error_message_ = "解调进行中，无法加载新文件";
+        return false;
+    }
+    error_message_.clear();
+    is_binary_file_ = false;
+    is_wav_file_ = false;
+    // 映射文件后直接在映射区上解析，不再把整个文件复制到堆上
+    if (!received_file_.Open(file_name)) {
+        error_message_ = QString("Cannot open file: %1")
+                         .arg(received_file_.get_error_message());
         return false;
     }
-    QTextStream in(&file);
-    txt_received_data_ = in.readAll();
-    file.close();
-    // 保存为接收到的调制数据
-    const auto value_strings = txt_received_data_.split(' ', Qt::SkipEmptyParts);
     txt_modulated_data_.clear();
-    txt_modulated_data_.reserve(value_strings.size());
-    txt_demodulated_data_.reserve(value_strings.size());
-    for (const auto &value_string : value_strings) {
-        bool ok{ false };
-        auto value = value_string.toDouble(&ok);
-        if (ok) {
-            txt_modulated_data_.append(value);
-        } else {
-            QMessageBox::warning(static_cast<QWidget *>(parent()), "Error", QString("Invalid data in file: %1")
-                                 .arg(value_string));
-            return false;
-        }
+    samples_ = nullptr;
+    sample_count_ = 0;
+    is_binary_file_ = SampleContainer::HasMagic(received_file_.data(), received_file_.size());
+    is_wav_file_ = !is_binary_file_ && WavFile::HasMagic(received_file_.data(), received_file_.size());
+    if (is_binary_file_) {
+        return LoadBinarySamples();
+    }
+    if (is_wav_file_) {
+        return LoadWavSamples(file_name);
+    }
+    // 保存为接收到的调制数据；直接解析映射区的字节，开头的 UTF-8 BOM 需自行跳过
+    QByteArray bad_token;
+    const auto *end = received_file_.data() + received_file_.size();
+    const auto *begin = SampleParser::SkipUtf8Bom(received_file_.data(), end);
+    Metrics::ScopedTimer timer(Metrics::kParse, received_file_.size());
+    if (!SampleParser::ParseSamples(begin, end, txt_modulated_data_, &bad_token)) {
+        error_message_ = QString("Invalid data in file: %1")
+                         .arg(QString::fromUtf8(bad_token));
+        return false;
+    }
+    samples_ = txt_modulated_data_.constData();
+    sample_count_ = txt_modulated_data_.size();
+    timer.set_items(sample_count_);
+    return true;
+}
+
+bool TxtModel::LoadBinarySamples()
+{
+    if (!SampleContainer::ReadHeader(received_file_.data(), received_file_.size(), sample_header_, &error_message_)) {
+        return false;
+    }
+    // 容器头自带发送端的调制参数，按其解调
+    if (!set_modem_params(ModemParams::FromHeader(sample_header_, modem_params_))) {
+        error_message_ = "采样文件的调制参数无效: " + error_message_;
+        return false;
+    }
+    const auto sample_size = SampleContainer::SampleSize(sample_header_.sample_type);
+    const auto available = (received_file_.size() - SampleContainer::kHeaderSize) / sample_size;
+    if (static_cast<quint64>(available) < sample_header_.sample_count) {
+        error_message_ = "采样文件不完整";
+        return false;
+    }
+    const auto *payload = received_file_.data() + SampleContainer::kHeaderSize;
+    sample_count_ = static_cast<qsizetype>(sample_header_.sample_count);
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    // float64 采样与内存布局一致，直接在映射区上解调
+    if (sample_header_.sample_type == SampleContainer::kFloat64) {
+        samples_ = reinterpret_cast<const double *>(payload);
+        return true;
+    }
+#endif
+    Metrics::ScopedTimer timer(Metrics::kParse, sample_count_ * sample_size, sample_count_);
+    txt_modulated_data_.resize(sample_count_);
+    SampleContainer::ConvertToDouble(payload, sample_header_.sample_type, sample_count_, txt_modulated_data_.data());
+    samples_ = txt_modulated_data_.constData();
+    return true;
+}
+
+bool TxtModel::LoadWavSamples(const QString &file_name)
+{
+    if (!WavFile::ReadInfo(file_name, wav_info_, &error_message_)) {
+        error_message_ = "WAV 文件无效: " + error_message_;
+        is_wav_file_ = false;
+        return false;
     }
+    ConvertWavSamples();
     return true;
 }
 
+void TxtModel::ConvertWavSamples()
+{
+    // 在映射区上按块解码，多声道取平均，采样率与调制参数不同时流式重采样；
+    // 整数采样归一化到 [-1, 1)，与文本采样的幅度一致。
+    // 降采样时先经抗混叠低通整数倍抽取，避免带外噪声折叠进调制信号所在的频带。
+    // 解调引擎需要完整的采样序列，结果整体保存为 double；录音采样率远高于调制采样率时
+    // 数据量随抽取大幅减小，采样率相同时约为 16 位 WAV 文件的 4 倍
+    const auto *data = received_file_.data() + wav_info_.data_offset;
+    const qint64 frames = wav_info_.FrameCount();
+    const int channels = wav_info_.channel_count;
+    Metrics::ScopedTimer timer(Metrics::kParse, wav_info_.data_size);
+    SampleConvert::Decimator decimator;
+    decimator.Reset(wav_info_.sample_rate, modem_params_.sample_rate);
+    SampleConvert::Resampler resampler;
+    resampler.Reset(1, decimator.get_output_rate(), modem_params_.sample_rate);
+    txt_modulated_data_.reserve(static_cast<qsizetype>(frames * modem_params_.sample_rate / wav_info_.sample_rate) + 2);
+    QList<float> decoded(kWavChunkFrames * channels);
+    QList<float> mono(kWavChunkFrames);
+    QList<float> decimated;
+    QList<float> resampled;
+    // 抽取后的单声道采样经重采样追加到调制数据
+    const auto append = [&](const float *samples, qsizetype count) {
+        if (!resampler.IsPassthrough()) {
+            resampled.clear();
+            count = resampler.Process(samples, count, resampled);
+            samples = resampled.constData();
+        }
+        const auto offset = txt_modulated_data_.size();
+        txt_modulated_data_.resize(offset + count);
+        double *out = txt_modulated_data_.data() + offset;
+        for (qsizetype i{ 0 }; i < count; ++i) {
+            out[i] = samples[i];
+        }
+    };
+    for (qint64 first{ 0 }; first < frames; first += kWavChunkFrames) {
+        const qint64 count = qMin(kWavChunkFrames, frames - first);
+        SampleConvert::Decode(data + first * wav_info_.block_align, wav_info_.encoding, count * channels, decoded.data());
+        const float *samples = decoded.constData();
+        if (channels != 1) {
+            SampleConvert::MixChannels(samples, channels, count, mono.data(), 1);
+            samples = mono.constData();
+        }
+        if (decimator.IsPassthrough()) {
+            append(samples, count);
+            continue;
+        }
+        decimated.clear();
+        decimator.Process(samples, count, decimated);
+        append(decimated.constData(), decimated.size());
+    }
+    // 冲出抽取滤波器中以末尾采样为中心的剩余输出
+    if (!decimator.IsPassthrough()) {
+        decimated.clear();
+        decimator.Flush(decimated);
+        append(decimated.constData(), decimated.size());
+    }
+    samples_ = txt_modulated_data_.constData();
+    sample_count_ = txt_modulated_data_.size();
+    timer.set_items(sample_count_);
+}
+
+QString TxtModel::get_txt_received_summary() const
+{
+    if (is_binary_file_) {
+        return QString("二进制采样文件: %1, 采样率 %2 Hz, 每比特 %3 点, 载波 %4 Hz, 共 %5 个采样")
+            .arg(SampleContainer::SampleTypeName(sample_header_.sample_type))
+            .arg(sample_header_.sample_rate)
+            .arg(sample_header_.samples_per_bit)
+            .arg(sample_header_.carrier_freq)
+            .arg(sample_count_);
+    }
+    if (is_wav_file_) {
+        return QString("WAV 音频文件: %1, %2 声道, %3 Hz, 按 %4 Hz 解调, 共 %5 个采样")
+            .arg(WavFile::EncodingName(wav_info_.encoding))
+            .arg(wav_info_.channel_count)
+            .arg(wav_info_.sample_rate)
+            .arg(modem_params_.sample_rate)
+            .arg(sample_count_);
+    }
+    return QString("文本采样文件: %1 字节, 共 %2 个采样")
+        .arg(received_file_.size())
+        .arg(sample_count_);
+}
+
 void TxtModel::DemodulateTxtFile(const QString &demodulate_t)
+{
+    // 同步解调：仍按块并行，但阻塞到完成
+    DemodEngine::Scheme scheme;
+    if (!PrepareDemodulation(demodulate_t, scheme)) {
+        return;
+    }
+    if (modem_params_.symbol_sync) {
+        sync_cancel_requested_ = false;
+        RunSymbolSync(scheme);
+        return;
+    }
+    const auto samples_per_bit = modem_params_.samples_per_bit;
+    demod_engine_->Run(scheme, samples_, sample_count_ / samples_per_bit, samples_per_bit,
+                       modem_params_.AskThreshold(), psk_reference_.constData(), txt_demodulated_data_.bytes());
+    ApplyTailBit();
+}
+
+bool TxtModel::StartDemodulation(const QString &demodulate_t)
+{
+    DemodEngine::Scheme scheme;
+    if (IsDemodulating() || !PrepareDemodulation(demodulate_t, scheme)) {
+        return false;
+    }
+    // 同步解调的环路状态逐比特传递，无法按块并行，整体交给后台线程顺序执行，
+    // 进度跨线程排队通知，完成后回到本对象所在线程发出完成信号
+    if (modem_params_.symbol_sync) {
+        sync_cancel_requested_ = false;
+        sync_running_ = true;
+        sync_pool_.start([this, scheme] {
+            const bool canceled = !RunSymbolSync(scheme);
+            QMetaObject::invokeMethod(this, [this, canceled] { onSymbolSyncFinished(canceled); }, Qt::QueuedConnection);
+        });
+        return true;
+    }
+    const auto samples_per_bit = modem_params_.samples_per_bit;
+    return demod_engine_->Start(scheme, samples_, sample_count_ / samples_per_bit, samples_per_bit,
+                                modem_params_.AskThreshold(), psk_reference_.constData(), txt_demodulated_data_.bytes());
+}
+
+void TxtModel::CancelDemodulation()
+{
+    demod_engine_->Cancel();
+    sync_cancel_requested_ = true;
+}
+
+bool TxtModel::PrepareDemodulation(const QString &demodulate_t, DemodEngine::Scheme &scheme)
 {
     if (demodulate_t.compare("ASK", Qt::CaseInsensitive) == 0) {
         // 检测振幅变化解调
-        // 按每位数据处理
-        for (auto i{ 0 }; i < txt_modulated_data_.size(); i += kSamplesPerBit) {
-            double energy{ 0.0 };
-            // 计算每比特占用的采样点数的能量
-            for (auto j{ 0 }; j < kSamplesPerBit && (i + j) < txt_modulated_data_.size(); ++j) {
-                energy += txt_modulated_data_[i + j] * txt_modulated_data_[i + j];
-            }
-            // 通过能量阈值判断比特值
-            const double threshold{ 0.5 * kSamplesPerBit / 10.0 };
-            txt_demodulated_data_.append(energy > threshold ? 1 : 0);
-        }
+        scheme = DemodEngine::kAsk;
     } else if (demodulate_t.compare("PSK", Qt::CaseInsensitive) == 0) {
         // 计算相关性解调
-        // 按每位数据处理
-        for (auto i{ 0 }; i < txt_modulated_data_.size(); i += kSamplesPerBit) {
-            double correlation{ 0.0 };
-            // 计算每比特占用的采样点数与载波间的相关性
-            for (auto j{ 0 }; j < kSamplesPerBit && (i + j) < txt_modulated_data_.size(); ++j) {
-                double t = static_cast<double>(j) / kSampleRate;
-                double reference_signal = sin(2 * M_PI * kCarrierFreq * t);
-                correlation += txt_modulated_data_[i + j] * reference_signal;
-            }
-            // 通过相关性判断比特值
-            // 与载波反相表示1，同相表示0
-            txt_demodulated_data_.append(correlation < 0 ? 1 : 0);
-        }
+        scheme = DemodEngine::kPsk;
+    } else {
+        return false;
+    }
+    // 预先分配输出，完整比特交给并行引擎，末尾不完整比特在此单独判决；
+    // 内核会整字节写出最后一个字节，因此该比特待引擎完成后再写入
+    const auto samples_per_bit = modem_params_.samples_per_bit;
+    const auto full_bits = sample_count_ / samples_per_bit;
+    const auto tail_samples = sample_count_ % samples_per_bit;
+    txt_demodulated_data_.Clear();
+    // 同步解调的比特数取决于定时恢复与前导码位置，由 RunSymbolSync 逐个追加
+    if (modem_params_.symbol_sync) {
+        has_tail_bit_ = false;
+        txt_demodulated_data_.Reserve(full_bits + 1);
+        return true;
+    }
+    txt_demodulated_data_.Resize(full_bits + (tail_samples ? 1 : 0));
+    has_tail_bit_ = tail_samples != 0;
+    if (has_tail_bit_) {
+        const auto *tail = samples_ + full_bits * samples_per_bit;
+        tail_bit_ = scheme == DemodEngine::kAsk ? DemodulateAskBit(tail, tail_samples, modem_params_.AskThreshold())
+                                                : DemodulatePskBit(tail, tail_samples, psk_reference_.constData());
     }
+    return true;
 }
 
-void TxtModel::DecodeTxtFile(const QString &decode_t)
+bool TxtModel::RunSymbolSync(DemodEngine::Scheme scheme)
 {
-    QByteArray decoded_bytes;
-    // 将比特位重组成字节
-    for (auto i{ 0 }; i < txt_demodulated_data_.size(); i += 8) {
-        if (i + 7 >= txt_demodulated_data_.size()) {
-            break;  // 跳过不完整字节
+    Metrics::ScopedTimer timer(Metrics::kDemodulate, sample_count_ * static_cast<qint64>(sizeof(double)));
+    SymbolSync symbol_sync;
+    symbol_sync.Reset(scheme == DemodEngine::kAsk ? SymbolSync::kAsk : SymbolSync::kPsk, modem_params_);
+    int last_percent{ -1 };
+    for (qsizetype offset{ 0 }; offset < sample_count_; offset += kSyncChunkSamples) {
+        if (sync_cancel_requested_.load(std::memory_order_relaxed)) {
+            return false;
         }
-        uint8_t byte{ 0 };
-        for (auto j{ 0 }; j < 8; ++j) {
-            byte |= (txt_demodulated_data_[i + j] << (7 - j));
+        const auto count = qMin(kSyncChunkSamples, sample_count_ - offset);
+        symbol_sync.Process(samples_ + offset, count, txt_demodulated_data_);
+        const int percent = static_cast<int>((offset + count) * 100 / sample_count_);
+        if (percent != last_percent) {
+            last_percent = percent;
+            emit demodulationProgress(percent);
         }
-        decoded_bytes.append(static_cast<char>(byte));
     }
+    symbol_sync.Flush(txt_demodulated_data_);
+    timer.set_items(txt_demodulated_data_.size());
+    return true;
+}
+
+void TxtModel::onSymbolSyncFinished(bool canceled)
+{
+    sync_running_ = false;
+    onDemodulationFinished(canceled);
+}
+
+void TxtModel::ApplyTailBit()
+{
+    if (has_tail_bit_) {
+        txt_demodulated_data_.SetBit(txt_demodulated_data_.size() - 1, tail_bit_);
+    }
+}
+
+void TxtModel::onDemodulationFinished(bool canceled)
+{
+    if (canceled) {
+        txt_demodulated_data_.Clear();
+    } else {
+        ApplyTailBit();
+    }
+    emit demodulationFinished(canceled);
+}
+
+uint8_t TxtModel::DemodulateAskBit(const double *samples, qsizetype count, double threshold)
+{
+    // 计算每比特占用的采样点数的能量，通过能量阈值判断比特值
+    return DemodKernels::Energy(samples, count) > threshold ? 1 : 0;
+}
+
+uint8_t TxtModel::DemodulatePskBit(const double *samples, qsizetype count, const double *reference)
+{
+    // 计算每比特占用的采样点数与载波间的相关性
+    // 与载波反相表示1，同相表示0
+    return DemodKernels::Correlation(samples, reference, count) < 0 ? 1 : 0;
+}
+
+void TxtModel::DecodeTxtFile(const QString &decode_t)
+{
+    // 比特流按高位在前紧凑存储，完整字节部分即为解码前的字节序列，无需逐位重组
+    const auto decoded_bytes = txt_demodulated_data_.CompleteBytes();
+    Metrics::ScopedTimer timer(Metrics::kDecode, decoded_bytes.size());
     // 根据编码类型解码文本
     if (decode_t.compare("UTF-8", Qt::CaseInsensitive) == 0) {
         txt_recovered_data_ = QString::fromUtf8(decoded_bytes);
     } else if (decode_t.compare("UTF-16", Qt::CaseInsensitive) == 0) {
         txt_recovered_data_ = QString::fromUtf16(
-            reinterpret_cast<const char16_t *>(decoded_bytes.constData()),
+            reinterpret_cast<const char16_t *>(decoded_bytes.data()),
             decoded_bytes.size() / 2
         );
     }
 }
 
-void TxtModel::SaveRecoverdFile(const QString &file_name)
+bool TxtModel::SaveRecoverdFile(const QString &file_name)
 {
     QFile file(file_name);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QMessageBox::warning(static_cast<QWidget *>(parent()), "Error", QString("Cannot open file: %1")
-                             .arg(file.errorString()));
-        return;
+        error_message_ = QString("Cannot open file: %1")
+                         .arg(file.errorString());
+        return false;
     }
     QTextStream out(&file);
     out << txt_recovered_data_;
     file.close();
+    return true;
 }
@@ -2,6 +2,15 @@
 
 #include <QObject>
 #include <QList>
+#include <QSpan>
+#include <QThreadPool>
+#include <atomic>
+#include "mappedfile.h"
+#include "samplecontainer.h"
+#include "demodengine.h"
+#include "bitstream.h"
+#include "modemparams.h"
+#include "wavfile.h"
 
 class TxtModel  : public QObject
 {
@@ -13,22 +22,75 @@ public:
 
     bool LoadTxtFile(const QString &file_name);
     void DemodulateTxtFile(const QString &demodulate_t);
+    // 异步解调，完成后发出 demodulationFinished；同步解调在后台线程顺序执行
+    bool StartDemodulation(const QString &demodulate_t);
+    void CancelDemodulation();
+    bool IsDemodulating() const { return demod_engine_->IsRunning() || sync_running_; }
     void DecodeTxtFile(const QString &decode_t);
-    void SaveRecoverdFile(const QString &file_name);
+    bool SaveRecoverdFile(const QString &file_name);
 
-    const QString &get_txt_received_data() const { return txt_received_data_; }
-    const QList<double> &get_txt_modulated_data() const { return txt_modulated_data_; }
-    const QList<uint8_t> &get_txt_demodulated_data() const { return txt_demodulated_data_; }
+    // 模型不依赖界面，失败时返回 false，由调用方读取错误信息并自行提示
+    QString get_error_message() const { return error_message_; }
+    // 已加载文件的概要；采样本身通过 get_txt_modulated_data 访问，不再整体转成文本
+    QString get_txt_received_summary() const;
+    QSpan<const double> get_txt_modulated_data() const { return QSpan<const double>(samples_, sample_count_); }
+    const BitStream &get_txt_demodulated_data() const { return txt_demodulated_data_; }
     const QString &get_txt_recovered_data() const { return txt_recovered_data_; }
 
-    static constexpr double kSampleRate{ 1600.0 };
-    static constexpr qsizetype kSamplesPerBit{ 16 };
-    static constexpr double kCarrierFreq{ 200 };
+    // 文本采样与 WAV 音频按此参数解调，WAV 重采样到其采样率；二进制容器加载时改用其文件头中的参数。
+    // 已加载 WAV 时修改采样率会从映射区重新转换采样，完成后发出 samplesReloaded
+    bool set_modem_params(const ModemParams &params);
+    const ModemParams &get_modem_params() const { return modem_params_; }
+
+    // 单个比特的解调判决，count 可小于每比特采样数（末尾不完整比特）
+    static uint8_t DemodulateAskBit(const double *samples, qsizetype count, double threshold);
+    static uint8_t DemodulatePskBit(const double *samples, qsizetype count, const double *reference);
+
+signals:
+    void demodulationProgress(int percent);
+    void demodulationFinished(bool canceled);
+    // 采样缓冲已被替换，此前通过 get_txt_modulated_data 取得的视图失效
+    void samplesReloaded();
+
+private slots:
+    void onDemodulationFinished(bool canceled);
+    void onSymbolSyncFinished(bool canceled);
 
 private:
-    QString txt_received_data_;
+    bool LoadBinarySamples();
+    bool LoadWavSamples(const QString &file_name);
+    void ConvertWavSamples();
+    bool PrepareDemodulation(const QString &demodulate_t, DemodEngine::Scheme &scheme);
+    void ApplyTailBit();
+    // 返回 false 表示被取消
+    bool RunSymbolSync(DemodEngine::Scheme scheme);
+
+private:
+    MappedFile received_file_;  // 原始接收文件的只读映射
+    bool is_binary_file_{ false };
+    SampleContainer::Header sample_header_;
+    bool is_wav_file_{ false };
+    WavFile::Info wav_info_;
+    ModemParams modem_params_;
+    QList<double> psk_reference_;  // 一个比特周期的载波参考，随调制参数更新
     QList<double> txt_modulated_data_;
-    QList<uint8_t> txt_demodulated_data_;
+    // 解调所用的采样视图：指向 txt_modulated_data_，或 float64 二进制文件的映射区
+    const double *samples_{ nullptr };
+    qsizetype sample_count_{ 0 };
+    DemodEngine *demod_engine_;
+    // 同步解调的环路状态逐比特传递，无法分块并行，在单线程池中顺序执行
+    QThreadPool sync_pool_;
+    bool sync_running_{ false };
+    std::atomic<bool> sync_cancel_requested_{ false };
+    BitStream txt_demodulated_data_;
+    bool has_tail_bit_{ false };
+    uint8_t tail_bit_{ 0 };
     QString txt_recovered_data_;
+    QString error_message_;
+
+    // WAV 音频按块解码、混为单声道并重采样，每块的帧数
+    static constexpr qint64 kWavChunkFrames{ 64 * 1024 };
+    // 同步解调每处理该数量的采样检查一次取消请求并上报进度
+    static constexpr qsizetype kSyncChunkSamples{ 1024 * 1024 };
 };
 
@@ -0,0 +1,309 @@
+﻿#include "waveformwidget.h"
+#include "demodkernels.h"
+#include <QPainter>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QtMath>
+#include <cmath>
+
+WaveformWidget::WaveformWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumHeight(180);
+}
+
+void WaveformWidget::set_samples(QSpan<const double> samples, const ModemParams &params)
+{
+    samples_ = samples;
+    modem_params_ = params;
+    // 一次线性扫描建立金字塔，之后任意缩放级别的绘制都只查询金字塔
+    sample_pyramid_.Build(samples_.data(), samples_.size());
+    const auto full = sample_pyramid_.RangeMinMax(0, samples_.size());
+    const double margin = qMax(1e-9, (full.max - full.min) * 0.05);
+    sample_low_ = full.min - margin;
+    sample_high_ = full.max + margin;
+    ComputeBitMetrics();
+    ResetView();
+}
+
+void WaveformWidget::set_modem_params(const ModemParams &params)
+{
+    if (params == modem_params_) {
+        return;
+    }
+    modem_params_ = params;
+    ComputeBitMetrics();
+    update();
+}
+
+void WaveformWidget::set_scheme(DemodEngine::Scheme scheme)
+{
+    scheme_ = scheme;
+    update();
+}
+
+void WaveformWidget::Clear()
+{
+    samples_ = QSpan<const double>();
+    sample_pyramid_.Clear();
+    energy_pyramid_.Clear();
+    correlation_pyramid_.Clear();
+    bit_energy_.clear();
+    bit_correlation_.clear();
+    constellation_ = QImage();
+    ResetView();
+}
+
+void WaveformWidget::ComputeBitMetrics()
+{
+    energy_pyramid_.Clear();
+    correlation_pyramid_.Clear();
+    constellation_ = QImage();
+    const auto samples_per_bit = modem_params_.samples_per_bit;
+    if (samples_.isEmpty() || !modem_params_.Validate()) {
+        bit_energy_.clear();
+        bit_correlation_.clear();
+        return;
+    }
+    // 同相分量与判决所用的参考一致，正交分量用于星座图
+    const auto in_phase = modem_params_.CarrierReference();
+    QList<double> quadrature(samples_per_bit);
+    for (qsizetype j{ 0 }; j < samples_per_bit; ++j) {
+        quadrature[j] = cos(2 * M_PI * modem_params_.carrier_freq * j / modem_params_.sample_rate);
+    }
+    const double in_phase_norm = qMax(1e-12, DemodKernels::Energy(in_phase.constData(), samples_per_bit));
+    const double quadrature_norm = qMax(1e-12, DemodKernels::Energy(quadrature.constData(), samples_per_bit));
+
+    const auto bit_count = samples_.size() / samples_per_bit;
+    bit_energy_.resize(bit_count);
+    bit_correlation_.resize(bit_count);
+    QList<quint32> histogram(kConstellationBins * kConstellationBins, 0);
+    quint32 peak{ 0 };
+    for (qsizetype bit{ 0 }; bit < bit_count; ++bit) {
+        const auto *samples = samples_.data() + bit * samples_per_bit;
+        bit_energy_[bit] = DemodKernels::Energy(samples, samples_per_bit);
+        bit_correlation_[bit] = DemodKernels::Correlation(samples, in_phase.constData(), samples_per_bit);
+        // 归一化后理想的 PSK 符号位于 (±1, 0)，ASK 符号位于 (0, 0) 与 (1, 0)
+        const double i = bit_correlation_[bit] / in_phase_norm;
+        const double q = DemodKernels::Correlation(samples, quadrature.constData(), samples_per_bit) / quadrature_norm;
+        const int column = static_cast<int>((i + kConstellationRange) / (2 * kConstellationRange) * kConstellationBins);
+        const int row = static_cast<int>((kConstellationRange - q) / (2 * kConstellationRange) * kConstellationBins);
+        if (column >= 0 && column < kConstellationBins && row >= 0 && row < kConstellationBins) {
+            peak = qMax(peak, ++histogram[row * kConstellationBins + column]);
+        }
+    }
+    energy_pyramid_.Build(bit_energy_.constData(), bit_energy_.size());
+    correlation_pyramid_.Build(bit_correlation_.constData(), bit_correlation_.size());
+
+    // 密度按对数映射亮度，少量离群点也能看见
+    constellation_ = QImage(kConstellationBins, kConstellationBins, QImage::Format_RGB32);
+    const double log_peak = std::log1p(static_cast<double>(peak));
+    for (int row{ 0 }; row < kConstellationBins; ++row) {
+        auto *line = reinterpret_cast<QRgb *>(constellation_.scanLine(row));
+        for (int column{ 0 }; column < kConstellationBins; ++column) {
+            const auto count = histogram[row * kConstellationBins + column];
+            const int level = count && log_peak > 0 ? 64 + static_cast<int>(191 * std::log1p(count) / log_peak) : 0;
+            line[column] = qRgb(level / 4, level, level / 2);
+        }
+    }
+}
+
+void WaveformWidget::ResetView()
+{
+    view_first_ = 0.0;
+    view_span_ = qMax<double>(1.0, samples_.size());
+    update();
+}
+
+void WaveformWidget::ClampView()
+{
+    const double total = qMax<double>(1.0, samples_.size());
+    // 最多放大到可见 8 个采样
+    view_span_ = qBound(qMin(8.0, total), view_span_, total);
+    view_first_ = qBound(0.0, view_first_, total - view_span_);
+}
+
+QRect WaveformWidget::ConstellationArea() const
+{
+    const int side = qMin(height() - 8, width() / 4);
+    return QRect(width() - side - 4, 4, side, side);
+}
+
+QRect WaveformWidget::PlotArea() const
+{
+    return QRect(4, 4, qMax(1, ConstellationArea().left() - 12), qMax(1, height() - 8));
+}
+
+void WaveformWidget::DrawTrace(QPainter &painter, const QRect &area, const MinMaxPyramid &pyramid,
+                               double first, double span, double scale, double low, double high, const QColor &color) const
+{
+    // scale 为金字塔中每个元素对应的采样数：波形为 1，每比特判决量为每比特采样数
+    const auto to_y = [&area, low, high](double value) {
+        return area.bottom() - (value - low) / (high - low) * area.height();
+    };
+    const double items_per_pixel = span / scale / area.width();
+    painter.setPen(color);
+    if (items_per_pixel < 1.0) {
+        // 放大到每个元素占多个像素时直接连线
+        const auto first_item = qMax<qsizetype>(0, static_cast<qsizetype>(first / scale) - 1);
+        const auto last_item = qMin<qsizetype>(pyramid.size(), static_cast<qsizetype>((first + span) / scale) + 2);
+        QList<QPointF> points;
+        points.reserve(last_item - first_item);
+        for (auto item{ first_item }; item < last_item; ++item) {
+            const double x = area.left() + ((item + 0.5) * scale - first) / span * area.width();
+            points.append(QPointF(x, to_y(pyramid.samples()[item])));
+        }
+        painter.drawPolyline(points.constData(), points.size());
+        return;
+    }
+    // 每个像素列画一条从最小值到最大值的竖线，并与上一列相连避免断裂
+    QList<QLineF> lines;
+    lines.reserve(area.width());
+    double previous_low{ 0.0 };
+    double previous_high{ 0.0 };
+    for (int column{ 0 }; column < area.width(); ++column) {
+        const auto item_first = static_cast<qsizetype>((first + column * span / area.width()) / scale);
+        const auto item_last = qMax(item_first + 1, static_cast<qsizetype>(std::ceil((first + (column + 1) * span / area.width()) / scale)));
+        if (item_first >= pyramid.size()) {
+            break;
+        }
+        const auto range = pyramid.RangeMinMax(item_first, item_last);
+        double y_low = to_y(range.min);
+        double y_high = to_y(range.max);
+        if (column > 0) {
+            y_low = qMax(y_low, previous_high);
+            y_high = qMin(y_high, previous_low);
+        }
+        previous_low = to_y(range.min);
+        previous_high = to_y(range.max);
+        const double x = area.left() + column + 0.5;
+        lines.append(QLineF(x, y_low, x, y_high));
+    }
+    painter.drawLines(lines.constData(), lines.size());
+}
+
+void WaveformWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.fillRect(rect(), QColor(24, 24, 28));
+    const auto plot = PlotArea();
+    const auto constellation_area = ConstellationArea();
+    painter.setPen(QColor(70, 70, 80));
+    painter.drawRect(plot);
+    painter.drawRect(constellation_area);
+    if (sample_pyramid_.isEmpty()) {
+        painter.setPen(QColor(160, 160, 160));
+        painter.drawText(plot, Qt::AlignCenter, "未加载采样");
+        return;
+    }
+
+    // 上 60% 为波形，下 40% 为每比特判决量
+    const int wave_height = plot.height() * 3 / 5;
+    const QRect wave_area(plot.left(), plot.top(), plot.width(), wave_height - 2);
+    const QRect metric_area(plot.left(), plot.top() + wave_height + 2, plot.width(), plot.height() - wave_height - 2);
+    painter.drawLine(plot.left(), plot.top() + wave_height, plot.right(), plot.top() + wave_height);
+
+    const auto samples_per_bit = modem_params_.samples_per_bit;
+    // 每比特至少 8 像素宽时画出比特边界
+    if (view_span_ / samples_per_bit <= plot.width() / 8.0) {
+        painter.setPen(QColor(50, 50, 60));
+        const auto first_bit = static_cast<qsizetype>(view_first_ / samples_per_bit);
+        for (auto bit{ first_bit }; bit * samples_per_bit <= view_first_ + view_span_; ++bit) {
+            const double x = plot.left() + (bit * samples_per_bit - view_first_) / view_span_ * plot.width();
+            painter.drawLine(QPointF(x, plot.top()), QPointF(x, plot.bottom()));
+        }
+    }
+    painter.setClipRect(wave_area);
+    DrawTrace(painter, wave_area, sample_pyramid_, view_first_, view_span_, 1.0,
+              sample_low_, sample_high_, QColor(90, 200, 255));
+
+    // 判决量与门限：ASK 为能量对门限，PSK 为相关值对 0
+    const auto &metric_pyramid = scheme_ == DemodEngine::kAsk ? energy_pyramid_ : correlation_pyramid_;
+    if (!metric_pyramid.isEmpty()) {
+        const double threshold = scheme_ == DemodEngine::kAsk ? modem_params_.AskThreshold() : 0.0;
+        const auto full = metric_pyramid.RangeMinMax(0, metric_pyramid.size());
+        double low = qMin<double>(full.min, threshold);
+        double high = qMax<double>(full.max, threshold);
+        const double margin = qMax(1e-9, (high - low) * 0.05);
+        low -= margin;
+        high += margin;
+        painter.setClipRect(metric_area);
+        DrawTrace(painter, metric_area, metric_pyramid, view_first_, view_span_, samples_per_bit,
+                  low, high, QColor(255, 190, 80));
+        const double y = metric_area.bottom() - (threshold - low) / (high - low) * metric_area.height();
+        painter.setPen(QPen(QColor(255, 90, 90), 1, Qt::DashLine));
+        painter.drawLine(QPointF(metric_area.left(), y), QPointF(metric_area.right(), y));
+    }
+    painter.setClipping(false);
+
+    if (!constellation_.isNull()) {
+        painter.drawImage(constellation_area.adjusted(1, 1, 0, 0), constellation_);
+        painter.setPen(QColor(90, 90, 100));
+        painter.drawLine(constellation_area.center().x(), constellation_area.top(),
+                         constellation_area.center().x(), constellation_area.bottom());
+        painter.drawLine(constellation_area.left(), constellation_area.center().y(),
+                         constellation_area.right(), constellation_area.center().y());
+    }
+
+    painter.setPen(QColor(200, 200, 200));
+    painter.drawText(plot.adjusted(6, 4, -6, -4), Qt::AlignLeft | Qt::AlignTop,
+                     QString("采样 %1 - %2 / %3    每像素 %4 点    %5")
+                     .arg(static_cast<qint64>(view_first_))
+                     .arg(static_cast<qint64>(view_first_ + view_span_))
+                     .arg(samples_.size())
+                     .arg(view_span_ / plot.width(), 0, 'f', 1)
+                     .arg(scheme_ == DemodEngine::kAsk ? "能量 / 门限" : "相关值 / 0"));
+    painter.drawText(constellation_area.adjusted(4, 2, -4, -2), Qt::AlignLeft | Qt::AlignTop, "I/Q");
+}
+
+void WaveformWidget::wheelEvent(QWheelEvent *event)
+{
+    const auto plot = PlotArea();
+    if (sample_pyramid_.isEmpty() || event->angleDelta().y() == 0) {
+        return;
+    }
+    // 以光标所在的采样为中心缩放
+    const double ratio = qBound(0.0, (event->position().x() - plot.left()) / plot.width(), 1.0);
+    const double anchor = view_first_ + ratio * view_span_;
+    view_span_ *= event->angleDelta().y() > 0 ? 1.0 / kZoomStep : kZoomStep;
+    ClampView();
+    view_first_ = anchor - ratio * view_span_;
+    ClampView();
+    update();
+    event->accept();
+}
+
+void WaveformWidget::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && PlotArea().contains(event->position().toPoint())) {
+        dragging_ = true;
+        drag_origin_x_ = event->position().x();
+        drag_origin_first_ = view_first_;
+        setCursor(Qt::ClosedHandCursor);
+    }
+}
+
+void WaveformWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!dragging_) {
+        return;
+    }
+    view_first_ = drag_origin_first_ - (event->position().x() - drag_origin_x_) / PlotArea().width() * view_span_;
+    ClampView();
+    update();
+}
+
+void WaveformWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && dragging_) {
+        dragging_ = false;
+        unsetCursor();
+    }
+}
+
+void WaveformWidget::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event);
+    ResetView();
+}
@@ -0,0 +1,67 @@
+﻿#pragma once
+
+#include <QWidget>
+#include <QImage>
+#include <QSpan>
+#include "minmaxpyramid.h"
+#include "modemparams.h"
+#include "demodengine.h"
+
+// 信号波形视图：上方为采样波形，下方为每比特的判决量（ASK 为能量，PSK 为与载波的相关值）
+// 及判决门限，右侧为按比特 I/Q 分量统计的星座密度图。
+// 波形与判决量均由最小/最大值金字塔按像素列取值，缩放、平移时不遍历全部采样。
+// 滚轮缩放，左键拖动平移，双击恢复全貌
+class WaveformWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    WaveformWidget(QWidget *parent = nullptr);
+
+    // samples 由调用方持有，需在下次 set_samples/Clear 前保持有效
+    void set_samples(QSpan<const double> samples, const ModemParams &params);
+    void set_modem_params(const ModemParams &params);
+    void set_scheme(DemodEngine::Scheme scheme);
+    void Clear();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+
+private:
+    void ComputeBitMetrics();
+    void ResetView();
+    void ClampView();
+    QRect PlotArea() const;
+    QRect ConstellationArea() const;
+    void DrawTrace(QPainter &painter, const QRect &area, const MinMaxPyramid &pyramid,
+                   double first, double span, double scale, double low, double high, const QColor &color) const;
+
+private:
+    QSpan<const double> samples_;
+    ModemParams modem_params_;
+    DemodEngine::Scheme scheme_{ DemodEngine::kAsk };
+    MinMaxPyramid sample_pyramid_;
+    // 每比特的判决量与对应金字塔
+    QList<double> bit_energy_;
+    QList<double> bit_correlation_;
+    MinMaxPyramid energy_pyramid_;
+    MinMaxPyramid correlation_pyramid_;
+    QImage constellation_;
+    double sample_low_{ -1.0 };
+    double sample_high_{ 1.0 };
+    // 可见区间，以采样为单位
+    double view_first_{ 0.0 };
+    double view_span_{ 1.0 };
+    bool dragging_{ false };
+    double drag_origin_x_{ 0.0 };
+    double drag_origin_first_{ 0.0 };
+
+    static constexpr int kConstellationBins{ 128 };
+    static constexpr double kConstellationRange{ 2.0 };  // 归一化 I/Q 的显示范围 [-2, 2]
+    static constexpr double kZoomStep{ 1.25 };
+};
@@ -0,0 +1,185 @@
+﻿#include "wavfile.h"
+#include <QFile>
+#include <QtEndian>
+#include <cstring>
+
+namespace WavFile {
+
+namespace {
+
+constexpr quint16 kFormatPcm{ 0x0001 };
+constexpr quint16 kFormatIeeeFloat{ 0x0003 };
+constexpr quint16 kFormatExtensible{ 0xFFFE };
+// fmt 块的最小长度（WAVEFORMAT）与 EXTENSIBLE 中子格式 GUID 的偏移
+constexpr qint64 kMinFmtSize{ 16 };
+constexpr qint64 kExtensibleSubFormatOffset{ 24 };
+// 录制中断或流式写入的文件常把 data 块长度留为 0 或 0xFFFFFFFF
+constexpr quint32 kUnknownChunkSize{ 0xFFFFFFFF };
+
+bool Fail(QString *error_message, const QString &error)
+{
+    if (error_message) {
+        *error_message = error;
+    }
+    return false;
+}
+
+Encoding EncodingFor(quint16 format_tag, int bits_per_sample)
+{
+    if (format_tag == kFormatPcm) {
+        switch (bits_per_sample) {
+        case 8:
+            return Encoding::kUInt8;
+        case 16:
+            return Encoding::kInt16;
+        case 24:
+            return Encoding::kInt24;
+        case 32:
+            return Encoding::kInt32;
+        }
+    } else if (format_tag == kFormatIeeeFloat) {
+        switch (bits_per_sample) {
+        case 32:
+            return Encoding::kFloat32;
+        case 64:
+            return Encoding::kFloat64;
+        }
+    }
+    return Encoding::kUnknown;
+}
+
+}
+
+bool HasMagic(const char *data, qint64 size)
+{
+    return size >= 12 && memcmp(data, "RIFF", 4) == 0 && memcmp(data + 8, "WAVE", 4) == 0;
+}
+
+bool ReadInfo(const QString &file_path, Info &info, QString *error_message)
+{
+    info = Info();
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Fail(error_message, file.errorString());
+    }
+    const qint64 file_size = file.size();
+    char riff_header[12];
+    if (file.read(riff_header, sizeof(riff_header)) != sizeof(riff_header)
+        || !HasMagic(riff_header, sizeof(riff_header))) {
+        return Fail(error_message, "不是 RIFF/WAVE 文件");
+    }
+
+    bool has_fmt{ false };
+    quint16 format_tag{ 0 };
+    qint64 position = sizeof(riff_header);
+    // 逐块遍历：块头 8 字节（标识 + 小端长度），内容长度为奇数时后跟 1 字节填充
+    while (position + 8 <= file_size) {
+        char chunk_header[8];
+        if (!file.seek(position) || file.read(chunk_header, sizeof(chunk_header)) != sizeof(chunk_header)) {
+            break;
+        }
+        const quint32 chunk_size = qFromLittleEndian<quint32>(chunk_header + 4);
+        const qint64 content_offset = position + 8;
+        if (memcmp(chunk_header, "fmt ", 4) == 0) {
+            if (chunk_size < kMinFmtSize) {
+                return Fail(error_message, "fmt 块过短");
+            }
+            const QByteArray fmt = file.read(qMin<qint64>(chunk_size, 64));
+            if (fmt.size() < kMinFmtSize) {
+                return Fail(error_message, "fmt 块不完整");
+            }
+            format_tag = qFromLittleEndian<quint16>(fmt.constData());
+            info.channel_count = qFromLittleEndian<quint16>(fmt.constData() + 2);
+            info.sample_rate = static_cast<int>(qFromLittleEndian<quint32>(fmt.constData() + 4));
+            info.block_align = qFromLittleEndian<quint16>(fmt.constData() + 12);
+            info.bits_per_sample = qFromLittleEndian<quint16>(fmt.constData() + 14);
+            // EXTENSIBLE 的实际格式为子格式 GUID 的前两个字节
+            if (format_tag == kFormatExtensible) {
+                if (fmt.size() < kExtensibleSubFormatOffset + 2) {
+                    return Fail(error_message, "WAVE_FORMAT_EXTENSIBLE 的 fmt 块不完整");
+                }
+                format_tag = qFromLittleEndian<quint16>(fmt.constData() + kExtensibleSubFormatOffset);
+            }
+            has_fmt = true;
+        } else if (memcmp(chunk_header, "data", 4) == 0) {
+            info.data_offset = content_offset;
+            const qint64 remaining = file_size - content_offset;
+            info.data_size = (chunk_size == 0 || chunk_size == kUnknownChunkSize)
+                                 ? remaining : qMin<qint64>(chunk_size, remaining);
+            // fmt 块理应在 data 之前；找到两者即可结束
+            if (has_fmt) {
+                break;
+            }
+        }
+        position = content_offset + chunk_size + (chunk_size & 1);
+        if (chunk_size == kUnknownChunkSize) {
+            break;
+        }
+    }
+
+    if (!has_fmt) {
+        return Fail(error_message, "缺少 fmt 块");
+    }
+    if (info.data_offset == 0) {
+        return Fail(error_message, "缺少 data 块");
+    }
+    info.encoding = EncodingFor(format_tag, info.bits_per_sample);
+    if (info.encoding == Encoding::kUnknown) {
+        return Fail(error_message, QString("不支持的采样格式: 格式码 0x%1, %2 位")
+                                   .arg(format_tag, 4, 16, QChar('0'))
+                                   .arg(info.bits_per_sample));
+    }
+    if (info.channel_count <= 0 || info.sample_rate <= 0
+        || info.block_align != info.channel_count * BytesPerSample(info.encoding)) {
+        return Fail(error_message, "fmt 块参数不一致");
+    }
+    // 末尾不完整的帧不播放
+    info.data_size -= info.data_size % info.block_align;
+    if (info.data_size <= 0) {
+        return Fail(error_message, "data 块为空");
+    }
+    return true;
+}
+
+int BytesPerSample(Encoding encoding)
+{
+    switch (encoding) {
+    case Encoding::kUInt8:
+        return 1;
+    case Encoding::kInt16:
+        return 2;
+    case Encoding::kInt24:
+        return 3;
+    case Encoding::kInt32:
+    case Encoding::kFloat32:
+        return 4;
+    case Encoding::kFloat64:
+        return 8;
+    case Encoding::kUnknown:
+        break;
+    }
+    return 0;
+}
+
+QString EncodingName(Encoding encoding)
+{
+    switch (encoding) {
+    case Encoding::kUInt8:
+        return "PCM 8 位";
+    case Encoding::kInt16:
+        return "PCM 16 位";
+    case Encoding::kInt24:
+        return "PCM 24 位";
+    case Encoding::kInt32:
+        return "PCM 32 位";
+    case Encoding::kFloat32:
+        return "浮点 32 位";
+    case Encoding::kFloat64:
+        return "浮点 64 位";
+    case Encoding::kUnknown:
+        break;
+    }
+    return "未知";
+}
+
+}
@@ -0,0 +1,40 @@
+﻿#pragma once
+
+#include <QtGlobal>
+#include <QString>
+
+// WAV 文件解析：逐块遍历 RIFF 结构，在任意位置找到 fmt 与 data 块，
+// 跳过 LIST、fact 等其他块。支持 PCM、IEEE 浮点与 WAVE_FORMAT_EXTENSIBLE，
+// 采样编码为 8 位无符号、16/24/32 位有符号整数或 32/64 位浮点
+namespace WavFile {
+
+enum class Encoding {
+    kUnknown,
+    kUInt8,
+    kInt16,
+    kInt24,
+    kInt32,
+    kFloat32,
+    kFloat64
+};
+
+struct Info {
+    Encoding encoding{ Encoding::kUnknown };
+    int channel_count{ 0 };
+    int sample_rate{ 0 };
+    int bits_per_sample{ 0 };
+    int block_align{ 0 };           // 每帧字节数
+    qint64 data_offset{ 0 };        // data 块内容在文件中的偏移
+    qint64 data_size{ 0 };          // 实际可用的数据长度（按整帧截断）
+
+    qint64 FrameCount() const { return block_align > 0 ? data_size / block_align : 0; }
+    double DurationSeconds() const { return sample_rate > 0 ? static_cast<double>(FrameCount()) / sample_rate : 0.0; }
+};
+
+// 检查 RIFF/WAVE 文件头，用于按内容区分文件类型
+bool HasMagic(const char *data, qint64 size);
+bool ReadInfo(const QString &file_path, Info &info, QString *error_message = nullptr);
+int BytesPerSample(Encoding encoding);
+QString EncodingName(Encoding encoding);
+
+}
@@ -0,0 +1,128 @@
+﻿#include "wavstreamdevice.h"
+#include <cstring>
+
+WavStreamDevice::WavStreamDevice(QObject *parent)
+    : QIODevice(parent)
+{}
+
+WavStreamDevice::~WavStreamDevice()
+{
+    close();
+}
+
+bool WavStreamDevice::Open(const QString &file_name, qint64 data_offset, qint64 data_size)
+{
+    close();
+    file_.setFileName(file_name);
+    if (!file_.open(QIODevice::ReadOnly)) {
+        error_message_ = file_.errorString();
+        return false;
+    }
+    if (data_offset < 0 || data_size < 0) {
+        error_message_ = "音频数据区无效";
+        file_.close();
+        return false;
+    }
+    // 数据区声明的长度超出文件时按实际长度截断（录制中断的文件常见）
+    data_offset_ = data_offset;
+    data_size_ = qBound<qint64>(0, data_size, file_.size() - data_offset);
+    read_pos_ = 0;
+    mapping_failed_ = false;
+    // 读取由本设备自行分窗，关闭 QIODevice 的内部缓冲，避免多一次复制
+    return QIODevice::open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+void WavStreamDevice::close()
+{
+    ReleaseWindow();
+    if (file_.isOpen()) {
+        file_.close();
+    }
+    data_offset_ = 0;
+    data_size_ = 0;
+    read_pos_ = 0;
+    if (isOpen()) {
+        QIODevice::close();
+    }
+}
+
+bool WavStreamDevice::seek(qint64 pos)
+{
+    if (pos < 0 || pos > data_size_ || !QIODevice::seek(pos)) {
+        return false;
+    }
+    read_pos_ = pos;
+    return true;
+}
+
+qint64 WavStreamDevice::readData(char *data, qint64 max_size)
+{
+    qint64 copied{ 0 };
+    while (copied < max_size && read_pos_ < data_size_) {
+        const qint64 file_offset = data_offset_ + read_pos_;
+        const qint64 window_end = window_begin_ + window_size_;
+        // 不在当前窗口内，或即将读到窗口末尾而文件后面还有数据时，滑动窗口
+        const bool outside = !window_data_ || file_offset < window_begin_ || file_offset >= window_end;
+        const bool near_end = window_end - file_offset < kReadAhead && window_end < data_offset_ + data_size_;
+        if ((outside || near_end) && !LoadWindow(file_offset)) {
+            return copied > 0 ? copied : -1;
+        }
+        const qint64 available = qMin(window_begin_ + window_size_, data_offset_ + data_size_) - file_offset;
+        const qint64 count = qMin(max_size - copied, available);
+        memcpy(data + copied, window_data_ + (file_offset - window_begin_), count);
+        copied += count;
+        read_pos_ += count;
+    }
+    return copied;
+}
+
+qint64 WavStreamDevice::writeData(const char *data, qint64 max_size)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(max_size);
+    return -1;
+}
+
+bool WavStreamDevice::LoadWindow(qint64 file_offset)
+{
+    ReleaseWindow();
+    const qint64 data_end = data_offset_ + data_size_;
+    if (!mapping_failed_) {
+        const qint64 begin = file_offset - file_offset % kMapAlignment;
+        const qint64 length = qMin(kWindowSize, data_end - begin);
+        mapped_ = file_.map(begin, length);
+        if (mapped_) {
+            window_data_ = reinterpret_cast<const char *>(mapped_);
+            window_begin_ = begin;
+            window_size_ = length;
+            return true;
+        }
+        // 部分文件系统不支持映射，此后一直使用分块读取
+        mapping_failed_ = true;
+    }
+    if (!file_.seek(file_offset)) {
+        error_message_ = file_.errorString();
+        return false;
+    }
+    fallback_window_ = file_.read(qMin(kWindowSize, data_end - file_offset));
+    if (fallback_window_.isEmpty()) {
+        error_message_ = file_.errorString();
+        return false;
+    }
+    window_data_ = fallback_window_.constData();
+    window_begin_ = file_offset;
+    window_size_ = fallback_window_.size();
+    return true;
+}
+
+void WavStreamDevice::ReleaseWindow()
+{
+    if (mapped_) {
+        file_.unmap(mapped_);
+        mapped_ = nullptr;
+    }
+    fallback_window_.clear();
+    window_data_ = nullptr;
+    window_begin_ = 0;
+    window_size_ = 0;
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include <QIODevice>
+#include <QFile>
+#include <QByteArray>
+
+// WAV 音频数据的流式读取设备：只映射当前读取位置附近的一个窗口，
+// 读到窗口末尾前滑动到下一个窗口，内存占用与文件长度无关。
+// 映射失败时回退为按窗口大小分块读取。可随机定位，定位只改变读取位置，
+// 下次读取时才加载对应窗口
+class WavStreamDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    WavStreamDevice(QObject *parent);
+    ~WavStreamDevice();
+
+    // 打开文件中从 data_offset 开始、长度为 data_size 的音频数据区
+    bool Open(const QString &file_name, qint64 data_offset, qint64 data_size);
+    void close() override;
+
+    bool isSequential() const override { return false; }
+    qint64 size() const override { return data_size_; }
+    bool seek(qint64 pos) override;
+    QString get_error_message() const { return error_message_; }
+
+protected:
+    qint64 readData(char *data, qint64 max_size) override;
+    qint64 writeData(const char *data, qint64 max_size) override;
+
+private:
+    bool LoadWindow(qint64 file_offset);
+    void ReleaseWindow();
+
+private:
+    QFile file_;
+    qint64 data_offset_{ 0 };
+    qint64 data_size_{ 0 };
+    qint64 read_pos_{ 0 };          // 相对音频数据区起点
+    // 当前窗口，window_begin_ 为文件偏移
+    uchar *mapped_{ nullptr };
+    QByteArray fallback_window_;
+    const char *window_data_{ nullptr };
+    qint64 window_begin_{ 0 };
+    qint64 window_size_{ 0 };
+    bool mapping_failed_{ false };
+    QString error_message_;
+
+    static constexpr qint64 kWindowSize{ 4 * 1024 * 1024 };
+    // 窗口起点按 64 KB 对齐，满足 Windows 的映射粒度
+    static constexpr qint64 kMapAlignment{ 64 * 1024 };
+    // 剩余不足该长度时提前滑动窗口，使一次读取尽量落在同一窗口内
+    static constexpr qint64 kReadAhead{ 512 * 1024 };
+};
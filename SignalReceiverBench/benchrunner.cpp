@@ -0,0 +1,99 @@
+﻿#include "benchrunner.h"
+#include <QJsonArray>
+#include <numeric>
+
+
+BenchRunner::Result &BenchRunner::Run(const QString &name, qint64 samples, qint64 bytes,
+                                      const std::function<void()> &body, const std::function<void()> &setup)
+{
+    QList<double> elapsed_ms;
+    elapsed_ms.reserve(iterations_);
+    // 先预热一次，排除首次缺页与指令集检测的开销
+    if (setup) {
+        setup();
+    }
+    body();
+    QElapsedTimer timer;
+    for (int i{ 0 }; i < iterations_; ++i) {
+        if (setup) {
+            setup();
+        }
+        timer.start();
+        body();
+        elapsed_ms.append(timer.nsecsElapsed() / 1e6);
+    }
+    return Add(name, samples, bytes, elapsed_ms);
+}
+
+BenchRunner::Result &BenchRunner::Add(const QString &name, qint64 samples, qint64 bytes, const QList<double> &elapsed_ms)
+{
+    Result result;
+    result.name = name;
+    result.iterations = elapsed_ms.size();
+    result.samples = samples;
+    result.bytes = bytes;
+    if (!elapsed_ms.isEmpty()) {
+        result.best_ms = *std::min_element(elapsed_ms.cbegin(), elapsed_ms.cend());
+        result.mean_ms = std::accumulate(elapsed_ms.cbegin(), elapsed_ms.cend(), 0.0) / elapsed_ms.size();
+    }
+    results_.append(result);
+    return results_.last();
+}
+
+BenchRunner::Result &BenchRunner::Fail(const QString &name, const QString &error)
+{
+    Result result;
+    result.name = name;
+    result.error = error;
+    results_.append(result);
+    return results_.last();
+}
+
+void BenchRunner::PrintTable(QTextStream &out) const
+{
+    out << QString("%1 %2 %3 %4 %5")
+           .arg("benchmark", -28)
+           .arg("best ms", 12)
+           .arg("mean ms", 12)
+           .arg("Msamples/s", 12)
+           .arg("MB/s", 12) << Qt::endl;
+    for (const auto &result : results_) {
+        if (!result.error.isEmpty()) {
+            out << QString("%1 FAILED: %2").arg(result.name, -28).arg(result.error) << Qt::endl;
+            continue;
+        }
+        out << QString("%1 %2 %3 %4 %5")
+               .arg(result.name, -28)
+               .arg(result.best_ms, 12, 'f', 3)
+               .arg(result.mean_ms, 12, 'f', 3)
+               .arg(SamplesPerSecond(result) / 1e6, 12, 'f', 2)
+               .arg(MegabytesPerSecond(result), 12, 'f', 2) << Qt::endl;
+    }
+}
+
+QJsonObject BenchRunner::ToJson(const QJsonObject &environment) const
+{
+    QJsonArray results;
+    for (const auto &result : results_) {
+        QJsonObject item;
+        item.insert("name", result.name);
+        item.insert("iterations", result.iterations);
+        item.insert("best_ms", result.best_ms);
+        item.insert("mean_ms", result.mean_ms);
+        item.insert("samples", result.samples);
+        item.insert("bytes", result.bytes);
+        item.insert("samples_per_second", SamplesPerSecond(result));
+        item.insert("megabytes_per_second", MegabytesPerSecond(result));
+        if (!result.error.isEmpty()) {
+            item.insert("error", result.error);
+        }
+        for (auto it = result.extra.begin(); it != result.extra.end(); ++it) {
+            item.insert(it.key(), it.value());
+        }
+        results.append(item);
+    }
+    QJsonObject root;
+    root.insert("environment", environment);
+    root.insert("results", results);
+    return root;
+}
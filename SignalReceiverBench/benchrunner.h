@@ -0,0 +1,50 @@
+﻿#pragma once
+
+#include <QString>
+#include <QList>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <functional>
+
+// 基准测试记录器：对每个用例重复计时，取最短与平均耗时，
+// 按 samples/s 与 MB/s 输出文本表格与 JSON，便于跨版本比较
+class BenchRunner
+{
+public:
+    struct Result {
+        QString name;
+        int iterations{ 0 };
+        double best_ms{ 0.0 };
+        double mean_ms{ 0.0 };
+        qint64 samples{ 0 };            // 每次迭代处理的采样数，0 表示不适用
+        qint64 bytes{ 0 };              // 每次迭代处理的字节数
+        QJsonObject extra;              // 用例附加信息，如误码数
+        QString error;                  // 用例失败原因，空表示成功
+    };
+
+    BenchRunner(int iterations) : iterations_(iterations) {}
+
+    // 重复执行 body；setup 在每次计时前执行且不计入耗时。返回本次的结果以便补充附加信息
+    Result &Run(const QString &name, qint64 samples, qint64 bytes,
+                const std::function<void()> &body, const std::function<void()> &setup = {});
+    // 由用例自行计时的结果（如需事件循环的网络用例）
+    Result &Add(const QString &name, qint64 samples, qint64 bytes, const QList<double> &elapsed_ms);
+    // 记录失败的用例，使其仍出现在表格与 JSON 中
+    Result &Fail(const QString &name, const QString &error);
+    bool HasFailures() const { return std::any_of(results_.cbegin(), results_.cend(), [](const Result &result) { return !result.error.isEmpty(); }); }
+
+    const QList<Result> &get_results() const { return results_; }
+    int get_iterations() const { return iterations_; }
+
+    void PrintTable(QTextStream &out) const;
+    QJsonObject ToJson(const QJsonObject &environment) const;
+
+    static double SamplesPerSecond(const Result &result) { return result.best_ms > 0.0 ? result.samples / (result.best_ms / 1000.0) : 0.0; }
+    static double MegabytesPerSecond(const Result &result) { return result.best_ms > 0.0 ? result.bytes / (1024.0 * 1024.0) / (result.best_ms / 1000.0) : 0.0; }
+
+private:
+    int iterations_;
+    QList<Result> results_;
+};
@@ -0,0 +1,559 @@
+﻿#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QThread>
+#include <QTimer>
+#include <limits>
+#include <memory>
+#include "benchrunner.h"
+#include "signalgenerator.h"
+#include "txtmodel.h"
+#include "networkmodel.h"
+#include "receiveserver.h"
+#include "demodkernels.h"
+#include "checksum.h"
+#include "sessionprotocol.h"
+
+namespace {
+
+bool WriteFile(const QString &file_path, const QByteArray &data)
+{
+    QFile file(file_path);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+// 旧协议：文件名 + 文件大小 + 文件内容
+QByteArray BuildLegacyStream(const QString &file_name, const QByteArray &data)
+{
+    QByteArray stream_data;
+    QDataStream stream(&stream_data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << file_name << static_cast<qint64>(data.size());
+    stream_data.append(data);
+    return stream_data;
+}
+
+// 会话协议数据帧；corrupt 时帧头中的 CRC 与负载不符
+void WriteDataFrame(QDataStream &stream, quint32 file_id, const char *data, qsizetype length, bool corrupt = false)
+{
+    const quint32 crc = Checksum::Crc32c(data, length);
+    stream << SessionProtocol::kMagic << static_cast<quint8>(SessionProtocol::kFileData) << file_id
+           << static_cast<quint32>(length) << (corrupt ? ~crc : crc);
+    stream.writeRawData(data, static_cast<int>(length));
+}
+
+// 会话协议：FileBegin + 若干 FileData 帧 + FileEnd
+QByteArray BuildSessionStream(const QString &file_name, const QByteArray &data, qsizetype frame_size)
+{
+    constexpr quint32 kFileId{ 1 };
+    QByteArray stream_data;
+    QDataStream stream(&stream_data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << SessionProtocol::kMagic << static_cast<quint8>(SessionProtocol::kFileBegin) << kFileId
+           << file_name << static_cast<qint64>(data.size());
+    for (qsizetype offset{ 0 }; offset < data.size(); offset += frame_size) {
+        WriteDataFrame(stream, kFileId, data.constData() + offset, qMin(frame_size, data.size() - offset));
+    }
+    stream << SessionProtocol::kMagic << static_cast<quint8>(SessionProtocol::kFileEnd) << kFileId
+           << Checksum::Crc32c(data.constData(), data.size());
+    return stream_data;
+}
+
+// 本机回环接收：本地 QTcpServer 充当发送端，NetworkModel 运行在独立线程中接收，
+// 计时从发起连接到文件落盘完成
+double RunLoopbackReceive(const QByteArray &stream_data, const QString &receive_dir, bool *ok)
+{
+    *ok = false;
+    QTcpServer sender;
+    if (!sender.listen(QHostAddress::LocalHost, 0)) {
+        return 0.0;
+    }
+    QObject::connect(&sender, &QTcpServer::newConnection, &sender, [&sender, &stream_data] {
+        auto socket = sender.nextPendingConnection();
+        socket->write(stream_data);
+    });
+    QThread network_thread;
+    auto network_model = new NetworkModel(nullptr);
+    network_model->set_receive_directory(receive_dir);
+    network_model->moveToThread(&network_thread);
+    network_thread.start();
+
+    QEventLoop loop;
+    QObject::connect(network_model, &NetworkModel::fileReceiveCompleted, &loop, [&loop, ok] {
+        *ok = true;
+        loop.quit();
+    });
+    QObject::connect(network_model, &NetworkModel::fileReceiveError, &loop, &QEventLoop::quit);
+    QTimer::singleShot(120000, &loop, &QEventLoop::quit);
+    QElapsedTimer timer;
+    timer.start();
+    const auto port = QString::number(sender.serverPort());
+    QMetaObject::invokeMethod(network_model, [network_model, port] {
+        network_model->StartConnection("127.0.0.1", port);
+    });
+    loop.exec();
+    const double elapsed_ms = timer.nsecsElapsed() / 1e6;
+    QMetaObject::invokeMethod(network_model, &NetworkModel::CloseConnection, Qt::BlockingQueuedConnection);
+    network_thread.quit();
+    network_thread.wait();
+    delete network_model;
+    return elapsed_ms;
+}
+
+// 续传检查的结果：每次连接收到的续传偏移与重连后重新发送的数据量
+struct ResumeResult {
+    QList<qint64> offsets;
+    qint64 resent_bytes{ 0 };
+    QString error;
+};
+
+// 续传回环接收：本地 QTcpServer 充当可续传的发送端，NetworkModel 在独立线程中接收并自动重连。
+// 发送端共经历三次连接，每次以 kFileResume 开始并等待接收端回复的偏移：
+//   第一次发送约一半的完整数据帧和半个数据帧后断开，接收端应丢弃未校验的半帧；
+//   第二次发送一个校验错误的数据帧，接收端应回退到上一个完整帧并断开重连；
+//   第三次从回复的偏移起发送剩余数据与 FileEnd。
+// 两次重连回复的偏移都应等于第一次断开前完整数据帧的总长度，最终文件须与原数据逐字节一致
+double RunResumeReceive(const QString &file_name, const QByteArray &data, qsizetype frame_size,
+                        const QString &receive_dir, ResumeResult *result)
+{
+    constexpr quint32 kFileId{ 1 };
+    const quint64 content_tag = Checksum::Crc32c(data.constData(), data.size());
+    const auto save_path = QDir(receive_dir).filePath(file_name);
+    QFile::remove(save_path);
+    QFile::remove(save_path + ".part");
+    QFile::remove(save_path + ".part.resume");
+    QTcpServer sender;
+    if (!sender.listen(QHostAddress::LocalHost, 0)) {
+        result->error = "无法监听回环端口";
+        return 0.0;
+    }
+    // 第一次连接在此处断开，之前为完整的数据帧
+    const qsizetype drop_offset = data.size() / 2 / frame_size * frame_size;
+    QObject::connect(&sender, &QTcpServer::newConnection, &sender, [&] {
+        auto socket = sender.nextPendingConnection();
+        const auto attempt = result->offsets.size();
+        QDataStream stream(socket);
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream << SessionProtocol::kMagic << static_cast<quint8>(SessionProtocol::kFileResume) << kFileId
+               << file_name << static_cast<qint64>(data.size()) << content_tag;
+        QObject::connect(socket, &QTcpSocket::readyRead, socket, [&, socket, attempt] {
+            QDataStream reply(socket);
+            reply.setVersion(QDataStream::Qt_6_0);
+            reply.startTransaction();
+            quint32 magic{ 0 };
+            quint8 type{ 0 };
+            quint32 file_id{ 0 };
+            qint64 offset{ 0 };
+            reply >> magic >> type >> file_id >> offset;
+            if (!reply.commitTransaction()) {
+                return;
+            }
+            QObject::disconnect(socket, &QTcpSocket::readyRead, nullptr, nullptr);
+            if (magic != SessionProtocol::kMagic || type != SessionProtocol::kResumeOffset || file_id != kFileId
+                || offset < 0 || offset > data.size()) {
+                result->error = "无效的续传偏移回复";
+                socket->abort();
+                return;
+            }
+            result->offsets.append(offset);
+            const auto resume_offset = static_cast<qsizetype>(offset);
+            QDataStream frames(socket);
+            frames.setVersion(QDataStream::Qt_6_0);
+            if (attempt == 0) {
+                for (qsizetype pos{ resume_offset }; pos < drop_offset; pos += frame_size) {
+                    WriteDataFrame(frames, kFileId, data.constData() + pos, qMin(frame_size, drop_offset - pos));
+                }
+                // 半个数据帧：帧头声明完整长度，负载只发出一半
+                const auto length = qMin(frame_size, data.size() - drop_offset);
+                frames << SessionProtocol::kMagic << static_cast<quint8>(SessionProtocol::kFileData) << kFileId
+                       << static_cast<quint32>(length) << Checksum::Crc32c(data.constData() + drop_offset, length);
+                frames.writeRawData(data.constData() + drop_offset, static_cast<int>(length / 2));
+                socket->disconnectFromHost();
+            } else if (attempt == 1) {
+                WriteDataFrame(frames, kFileId, data.constData() + resume_offset,
+                               qMin(frame_size, data.size() - resume_offset), true);
+            } else {
+                for (qsizetype pos{ resume_offset }; pos < data.size(); pos += frame_size) {
+                    WriteDataFrame(frames, kFileId, data.constData() + pos, qMin(frame_size, data.size() - pos));
+                }
+                frames << SessionProtocol::kMagic << static_cast<quint8>(SessionProtocol::kFileEnd) << kFileId
+                       << Checksum::Crc32c(data.constData(), data.size());
+                result->resent_bytes = data.size() - resume_offset;
+            }
+        });
+    });
+    QThread network_thread;
+    auto network_model = new NetworkModel(nullptr);
+    network_model->set_receive_directory(receive_dir);
+    network_model->set_connect_retry_policy(3, 10);
+    network_model->moveToThread(&network_thread);
+    network_thread.start();
+
+    QEventLoop loop;
+    bool completed{ false };
+    QObject::connect(network_model, &NetworkModel::fileReceiveCompleted, &loop, [&loop, &completed] {
+        completed = true;
+        loop.quit();
+    });
+    // 续传过程中的数据帧错误属预期，只有连接最终失败才结束
+    QObject::connect(network_model, &NetworkModel::connectionChanged, &loop, [&loop](NetworkModel::ConnectionState state) {
+        if (state == NetworkModel::Error) {
+            loop.quit();
+        }
+    });
+    QTimer::singleShot(120000, &loop, &QEventLoop::quit);
+    QElapsedTimer timer;
+    timer.start();
+    const auto port = QString::number(sender.serverPort());
+    QMetaObject::invokeMethod(network_model, [network_model, port] {
+        network_model->StartConnection("127.0.0.1", port);
+    });
+    loop.exec();
+    const double elapsed_ms = timer.nsecsElapsed() / 1e6;
+    QMetaObject::invokeMethod(network_model, &NetworkModel::CloseConnection, Qt::BlockingQueuedConnection);
+    network_thread.quit();
+    network_thread.wait();
+    delete network_model;
+
+    if (!result->error.isEmpty()) {
+        return elapsed_ms;
+    }
+    const QList<qint64> expected_offsets{ 0, drop_offset, drop_offset };
+    QFile saved_file(save_path);
+    if (!completed) {
+        result->error = "文件未完成接收";
+    } else if (result->offsets != expected_offsets) {
+        result->error = "续传偏移与预期不符";
+    } else if (!saved_file.open(QIODevice::ReadOnly) || saved_file.readAll() != data) {
+        result->error = "接收的文件与原数据不一致";
+    } else if (QFile::exists(save_path + ".part") || QFile::exists(save_path + ".part.resume")) {
+        result->error = "续传的临时文件未被清理";
+    }
+    return elapsed_ms;
+}
+
+// 回环发送端：按发送窗口分块写出整个数据流，不把整个流复制进套接字的写缓冲
+void StartLoopbackSender(QObject *host, const QByteArray &stream_data, quint16 port)
+{
+    constexpr qsizetype kSendChunk{ 256 * 1024 };
+    auto socket = new QTcpSocket(host);
+    auto offset = std::make_shared<qsizetype>(0);
+    const auto write_more = [socket, &stream_data, offset] {
+        while (*offset < stream_data.size() && socket->bytesToWrite() < kSendChunk) {
+            const auto length = qMin(kSendChunk, stream_data.size() - *offset);
+            socket->write(stream_data.constData() + *offset, length);
+            *offset += length;
+        }
+    };
+    QObject::connect(socket, &QTcpSocket::connected, socket, write_more);
+    QObject::connect(socket, &QTcpSocket::bytesWritten, socket, write_more);
+    socket->connectToHost(QHostAddress::LocalHost, port);
+}
+
+// 服务器模式回环接收：ReceiveServer 以指定工作线程数监听，发送端在独立线程中同时发起全部连接，
+// 计时从发起连接到全部文件落盘完成
+double RunServerReceive(const QList<QByteArray> &streams, int worker_count, const QString &receive_dir, bool *ok)
+{
+    *ok = false;
+    // ReceiveServer 需要明确的端口，先由系统分配一个空闲端口
+    quint16 port{ 0 };
+    {
+        QTcpServer probe;
+        if (!probe.listen(QHostAddress::LocalHost, 0)) {
+            return 0.0;
+        }
+        port = probe.serverPort();
+    }
+    ReceiveServer server(nullptr);
+    server.set_receive_directory(receive_dir);
+    server.set_worker_count(worker_count);
+    if (!server.Start("127.0.0.1", QString::number(port))) {
+        return 0.0;
+    }
+
+    QEventLoop loop;
+    qsizetype completed{ 0 };
+    QObject::connect(&server, &ReceiveServer::fileReceiveCompleted, &loop, [&loop, &completed, &streams, ok] {
+        if (++completed == streams.size()) {
+            *ok = true;
+            loop.quit();
+        }
+    });
+    QObject::connect(&server, &ReceiveServer::fileReceiveError, &loop, &QEventLoop::quit);
+    QTimer::singleShot(120000, &loop, &QEventLoop::quit);
+    QThread sender_thread;
+    auto sender_host = new QObject;
+    sender_host->moveToThread(&sender_thread);
+    sender_thread.start();
+    QElapsedTimer timer;
+    timer.start();
+    QMetaObject::invokeMethod(sender_host, [sender_host, &streams, port] {
+        for (const auto &stream_data : streams) {
+            StartLoopbackSender(sender_host, stream_data, port);
+        }
+    });
+    loop.exec();
+    const double elapsed_ms = timer.nsecsElapsed() / 1e6;
+    QMetaObject::invokeMethod(sender_host, [sender_host] { delete sender_host; }, Qt::BlockingQueuedConnection);
+    sender_thread.quit();
+    sender_thread.wait();
+    server.Stop();
+    return elapsed_ms;
+}
+
+}
+
+// 基准测试：生成合成采样，依次测量文本/二进制加载、ASK/PSK 解调、解码与本机回环接收，
+// 结果以表格输出到标准输出，并以 JSON 写入文件或标准输出
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("SignalReceiverBench");
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("SignalReceiver 基准测试");
+    parser.addHelpOption();
+    const QCommandLineOption payload_option("payload-kb", "调制负载大小（KB）", "kb", "32");
+    const QCommandLineOption snr_option("snr", "信噪比（dB），inf 表示无噪声", "db", "20");
+    const QCommandLineOption iterations_option({ "n", "iterations" }, "每个用例的计时次数", "n", "5");
+    const QCommandLineOption seed_option("seed", "随机数种子", "seed", "1");
+    const QCommandLineOption json_option("json", "JSON 结果输出文件，- 表示标准输出", "file");
+    const QCommandLineOption isa_option("isa", "强制解调内核指令集: scalar/sse2/avx2", "isa");
+    parser.addOptions({ payload_option, snr_option, iterations_option, seed_option, json_option, isa_option });
+    parser.process(app);
+
+    const qsizetype payload_size = parser.value(payload_option).toLongLong() * 1024;
+    const auto snr_text = parser.value(snr_option);
+    const double snr_db = snr_text.compare("inf", Qt::CaseInsensitive) == 0
+                              ? std::numeric_limits<double>::infinity() : snr_text.toDouble();
+    const int iterations = qMax(1, parser.value(iterations_option).toInt());
+    const auto seed = parser.value(seed_option).toUInt();
+    if (payload_size <= 0) {
+        err << "负载大小必须为正数" << Qt::endl;
+        return 2;
+    }
+    if (parser.isSet(isa_option)) {
+        const auto isa = parser.value(isa_option).toLower();
+        DemodKernels::ForceIsa(isa == "scalar" ? DemodKernels::Isa::kScalar
+                               : isa == "sse2" ? DemodKernels::Isa::kSse2 : DemodKernels::Isa::kAvx2);
+    }
+    QTemporaryDir work_dir;
+    if (!work_dir.isValid()) {
+        err << "无法创建临时目录" << Qt::endl;
+        return 1;
+    }
+
+    // 生成测试数据
+    out << "生成测试数据: 负载 " << payload_size << " 字节, 信噪比 " << snr_text << " dB" << Qt::endl;
+    const auto payload = SignalGenerator::MakePayload(payload_size, seed);
+    const auto ask_samples = SignalGenerator::Modulate(payload, SignalGenerator::Scheme::kAsk, snr_db, seed);
+    const auto psk_samples = SignalGenerator::Modulate(payload, SignalGenerator::Scheme::kPsk, snr_db, seed);
+    const auto sample_count = static_cast<qint64>(ask_samples.size());
+    const auto ask_text = SignalGenerator::ToText(ask_samples);
+    const auto psk_text = SignalGenerator::ToText(psk_samples);
+    const auto ask_float64 = SignalGenerator::ToContainer(ask_samples, SampleContainer::kFloat64);
+    const auto ask_int16 = SignalGenerator::ToContainer(ask_samples, SampleContainer::kInt16);
+    const auto ask_text_path = work_dir.filePath("ask.txt");
+    const auto psk_text_path = work_dir.filePath("psk.txt");
+    const auto ask_float64_path = work_dir.filePath("ask_f64.srb");
+    const auto ask_int16_path = work_dir.filePath("ask_i16.srb");
+    if (!WriteFile(ask_text_path, ask_text) || !WriteFile(psk_text_path, psk_text)
+        || !WriteFile(ask_float64_path, ask_float64) || !WriteFile(ask_int16_path, ask_int16)) {
+        err << "无法写入测试数据" << Qt::endl;
+        return 1;
+    }
+
+    BenchRunner runner(iterations);
+    TxtModel txt_model(nullptr);
+    bool load_ok{ true };
+    const auto load = [&txt_model, &load_ok](const QString &file_path) {
+        return [&txt_model, &load_ok, file_path] { load_ok = txt_model.LoadTxtFile(file_path) && load_ok; };
+    };
+
+    // 加载与解析
+    runner.Run("load_text", sample_count, ask_text.size(), load(ask_text_path));
+    runner.Run("load_binary_float64", sample_count, ask_float64.size(), load(ask_float64_path));
+    runner.Run("load_binary_int16", sample_count, ask_int16.size(), load(ask_int16_path));
+    if (!load_ok) {
+        err << "加载测试数据失败: " << txt_model.get_error_message() << Qt::endl;
+        return 1;
+    }
+
+    // 解调，附带误码统计以确认结果有效
+    // 文本文件按默认参数加载，二进制容器使用其文件头中的参数
+    const auto demodulate = [&](const QString &name, const QString &file_path, const QString &scheme,
+                                const ModemParams &params = ModemParams()) -> BenchRunner::Result & {
+        txt_model.set_modem_params(params);
+        txt_model.LoadTxtFile(file_path);
+        const auto samples = static_cast<qint64>(txt_model.get_txt_modulated_data().size());
+        auto &result = runner.Run(name, samples, samples * static_cast<qint64>(sizeof(double)),
+                                  [&txt_model, scheme] { txt_model.DemodulateTxtFile(scheme); });
+        const auto bits = txt_model.get_txt_demodulated_data().CompleteBytes();
+        const auto errors = SignalGenerator::CountBitErrors(payload, QByteArray(bits.data(), bits.size()));
+        result.extra.insert("bit_errors", errors);
+        result.extra.insert("bit_error_rate", static_cast<double>(errors) / (payload.size() * 8));
+        result.extra.insert("samples_per_bit", static_cast<qint64>(txt_model.get_modem_params().samples_per_bit));
+        result.extra.insert("fixed_kernel", DemodKernels::HasFixedKernel(txt_model.get_modem_params().samples_per_bit));
+        return result;
+    };
+    demodulate("demodulate_ask", ask_float64_path, "ASK");
+    demodulate("demodulate_psk", psk_text_path, "PSK");
+    // 同步解调逐采样顺序执行（载波与位定时环路），与并行引擎对比吞吐
+    ModemParams sync_params;
+    sync_params.symbol_sync = true;
+    demodulate("demodulate_psk_sync", psk_text_path, "PSK", sync_params);
+    // 同步解调在实际录音条件下：连续相位载波、2% 时钟偏差、5 Hz 载波频偏与前置噪声，
+    // 以前导码定帧，误码统计仅比较前导码之后的负载
+    ModemParams drift_params;
+    drift_params.symbol_sync = true;
+    drift_params.preamble = QByteArray::fromHex("55552dd4");
+    SignalGenerator::Impairments impairments;
+    impairments.clock_offset = 0.02;
+    impairments.carrier_offset_hz = 5.0;
+    impairments.carrier_phase = 0.7;
+    impairments.lead_in_samples = 37.3;
+    for (const auto scheme : { SignalGenerator::Scheme::kPsk, SignalGenerator::Scheme::kAsk }) {
+        const QString scheme_name = scheme == SignalGenerator::Scheme::kPsk ? "PSK" : "ASK";
+        const auto samples = SignalGenerator::ModulateContinuous(drift_params.preamble + payload, scheme,
+                                                                 snr_db, seed, drift_params, impairments);
+        const auto file_path = work_dir.filePath(QString("%1_drift.txt").arg(scheme_name.toLower()));
+        if (!WriteFile(file_path, SignalGenerator::ToText(samples))) {
+            err << "无法写入测试数据" << Qt::endl;
+            return 1;
+        }
+        auto &result = demodulate(QString("demodulate_%1_sync_drift").arg(scheme_name.toLower()), file_path,
+                                  scheme_name, drift_params);
+        result.extra.insert("clock_offset", impairments.clock_offset);
+        result.extra.insert("carrier_offset_hz", impairments.carrier_offset_hz);
+    }
+    // 其他每比特采样数：8/32 走专用内核，24 走通用循环，用于对比分派开销
+    for (const qsizetype samples_per_bit : { 8, 24, 32 }) {
+        ModemParams params;
+        params.samples_per_bit = samples_per_bit;
+        params.sample_rate = params.carrier_freq * samples_per_bit / 2;
+        const auto samples = SignalGenerator::Modulate(payload, SignalGenerator::Scheme::kPsk, snr_db, seed, params);
+        const auto file_path = work_dir.filePath(QString("psk_spb%1.srb").arg(samples_per_bit));
+        if (!WriteFile(file_path, SignalGenerator::ToContainer(samples, SampleContainer::kFloat64, params))) {
+            err << "无法写入测试数据" << Qt::endl;
+            return 1;
+        }
+        demodulate(QString("demodulate_psk_spb%1").arg(samples_per_bit), file_path, "PSK");
+    }
+
+    // 解码
+    txt_model.LoadTxtFile(ask_float64_path);
+    txt_model.DemodulateTxtFile("ASK");
+    runner.Run("decode_utf8", 0, payload.size(), [&txt_model] { txt_model.DecodeTxtFile("UTF-8"); });
+    runner.Run("decode_utf16", 0, payload.size(), [&txt_model] { txt_model.DecodeTxtFile("UTF-16"); });
+
+    // 本机回环接收
+    const auto receive_dir = work_dir.filePath("received");
+    QDir().mkpath(receive_dir);
+    const auto receive = [&](const QString &name, const QByteArray &stream_data, qint64 file_size) {
+        QList<double> elapsed_ms;
+        for (int i{ 0 }; i < iterations; ++i) {
+            bool ok{ false };
+            const double ms = RunLoopbackReceive(stream_data, receive_dir, &ok);
+            if (!ok) {
+                err << name << " 接收失败" << Qt::endl;
+                runner.Fail(name, "接收失败");
+                return;
+            }
+            elapsed_ms.append(ms);
+        }
+        runner.Add(name, sample_count, file_size, elapsed_ms);
+    };
+    receive("tcp_receive_legacy", BuildLegacyStream("ask_f64.srb", ask_float64), ask_float64.size());
+    receive("tcp_receive_session", BuildSessionStream("ask_f64.srb", ask_float64, 1024 * 1024), ask_float64.size());
+
+    // 断点续传：断线、数据帧损坏后两次重连，核对续传偏移与最终文件，失败时以非零状态退出
+    {
+        ResumeResult resume;
+        const double ms = RunResumeReceive("resume.srb", ask_float64, 1024 * 1024, receive_dir, &resume);
+        if (!resume.error.isEmpty()) {
+            err << "tcp_receive_resume 失败: " << resume.error << Qt::endl;
+            return 1;
+        }
+        auto &result = runner.Add("tcp_receive_resume", sample_count, ask_float64.size(), { ms });
+        QJsonArray offsets;
+        for (const auto offset : std::as_const(resume.offsets)) {
+            offsets.append(offset);
+        }
+        result.extra.insert("resume_offsets", offsets);
+        result.extra.insert("resent_bytes", resume.resent_bytes);
+    }
+
+    // 服务器模式：1/8/64 个发送端同时连接，总数据量固定并均分给各发送端，
+    // 分别以单个工作线程与按 CPU 核数的工作线程接收，对比总吞吐随核数的扩展
+    QList<int> worker_counts{ 1 };
+    if (QThread::idealThreadCount() > 1) {
+        worker_counts.append(QThread::idealThreadCount());
+    }
+    for (const int sender_count : { 1, 8, 64 }) {
+        const auto share = (ask_float64.size() + sender_count - 1) / sender_count;
+        QList<QByteArray> streams;
+        qint64 total_bytes{ 0 };
+        for (int i{ 0 }; i < sender_count; ++i) {
+            const auto data = ask_float64.mid(i * share, share);
+            streams.append(BuildSessionStream(QString("sender%1.srb").arg(i), data, 1024 * 1024));
+            total_bytes += data.size();
+        }
+        for (const int worker_count : std::as_const(worker_counts)) {
+            const auto name = QString("tcp_server_%1_w%2").arg(sender_count).arg(worker_count);
+            QList<double> elapsed_ms;
+            for (int i{ 0 }; i < iterations; ++i) {
+                bool ok{ false };
+                const double ms = RunServerReceive(streams, worker_count, receive_dir, &ok);
+                if (!ok) {
+                    err << name << " 接收失败" << Qt::endl;
+                    runner.Fail(name, "接收失败");
+                    break;
+                }
+                elapsed_ms.append(ms);
+            }
+            if (elapsed_ms.size() == iterations) {
+                auto &result = runner.Add(name, 0, total_bytes, elapsed_ms);
+                result.extra.insert("senders", sender_count);
+                result.extra.insert("workers", worker_count);
+            }
+        }
+    }
+
+    runner.PrintTable(out);
+
+    if (parser.isSet(json_option)) {
+        QJsonObject environment;
+        environment.insert("timestamp", QDateTime::currentDateTimeUtc().toString(Qt::ISODate));
+        environment.insert("qt_version", qVersion());
+        environment.insert("cpu_architecture", QSysInfo::currentCpuArchitecture());
+        environment.insert("os", QSysInfo::prettyProductName());
+        environment.insert("demod_isa", DemodKernels::IsaName(DemodKernels::ActiveIsa()));
+        environment.insert("ideal_thread_count", QThread::idealThreadCount());
+        environment.insert("payload_bytes", payload_size);
+        environment.insert("sample_count", sample_count);
+        environment.insert("snr_db", snr_text);
+        environment.insert("seed", static_cast<qint64>(seed));
+        const auto json = QJsonDocument(runner.ToJson(environment)).toJson(QJsonDocument::Indented);
+        const auto json_path = parser.value(json_option);
+        if (json_path == "-") {
+            out << json;
+        } else if (!WriteFile(json_path, json)) {
+            err << "无法写入 " << json_path << Qt::endl;
+            return 1;
+        }
+    }
+    // 有用例失败时仍输出表格与 JSON，但以非零状态退出
+    return runner.HasFailures() ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+﻿#include "signalgenerator.h"
+#include <QtEndian>
+#include <QtAlgorithms>
+#include <QtMath>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace SignalGenerator {
+
+QByteArray MakePayload(qsizetype size, quint32 seed)
+{
+    static constexpr char kAlphabet[] = "abcdefghijklmnopqrstuvwxyz ABCDEFGHIJKLMNOPQRSTUVWXYZ 0123456789,.\n";
+    std::mt19937 engine(seed);
+    std::uniform_int_distribution<int> pick(0, static_cast<int>(sizeof(kAlphabet)) - 2);
+    QByteArray payload(size, Qt::Uninitialized);
+    for (auto &c : payload) {
+        c = kAlphabet[pick(engine)];
+    }
+    return payload;
+}
+
+QList<double> Modulate(const QByteArray &payload, Scheme scheme, double snr_db, quint32 seed,
+                       const ModemParams &params)
+{
+    const auto spb = params.samples_per_bit;
+    const auto carrier = params.CarrierReference();
+    // 单位幅度正弦载波的功率为 0.5
+    const bool add_noise = std::isfinite(snr_db);
+    const double noise_sigma = add_noise ? std::sqrt(0.5 / std::pow(10.0, snr_db / 10.0)) : 0.0;
+    std::mt19937 engine(seed);
+    std::normal_distribution<double> noise(0.0, noise_sigma);
+
+    QList<double> samples(payload.size() * 8 * spb);
+    auto *out = samples.data();
+    for (const auto byte : payload) {
+        for (int b{ 7 }; b >= 0; --b) {
+            const bool bit = (static_cast<quint8>(byte) >> b) & 1;
+            // ASK：1 发载波、0 静默；PSK：1 反相、0 同相
+            const double gain = scheme == Scheme::kAsk ? (bit ? 1.0 : 0.0) : (bit ? -1.0 : 1.0);
+            for (qsizetype j{ 0 }; j < spb; ++j) {
+                *out++ = gain * carrier[j] + (add_noise ? noise(engine) : 0.0);
+            }
+        }
+    }
+    return samples;
+}
+
+QList<double> ModulateContinuous(const QByteArray &payload, Scheme scheme, double snr_db, quint32 seed,
+                                 const ModemParams &params, const Impairments &impairments)
+{
+    const double spb = static_cast<double>(params.samples_per_bit);
+    const qint64 bit_count = payload.size() * 8;
+    const double carrier_step = 2 * M_PI * (params.carrier_freq + impairments.carrier_offset_hz) / params.sample_rate;
+    const bool add_noise = std::isfinite(snr_db);
+    const double noise_sigma = add_noise ? std::sqrt(0.5 / std::pow(10.0, snr_db / 10.0)) : 0.0;
+    std::mt19937 engine(seed);
+    std::normal_distribution<double> noise(0.0, noise_sigma);
+
+    // 第 n 个采样位于发送端时间轴上的 n * (1 + clock_offset) - lead_in 处
+    const double rate = 1.0 + impairments.clock_offset;
+    QList<double> samples;
+    samples.reserve(static_cast<qsizetype>((bit_count * spb + impairments.lead_in_samples) / rate) + 1);
+    for (qint64 n{ 0 };; ++n) {
+        const double position = n * rate - impairments.lead_in_samples;
+        double value{ 0.0 };
+        if (position >= 0.0) {
+            const qint64 index = static_cast<qint64>(position / spb);
+            if (index >= bit_count) {
+                break;
+            }
+            const bool bit = (static_cast<quint8>(payload[index / 8]) >> (7 - index % 8)) & 1;
+            const double gain = scheme == Scheme::kAsk ? (bit ? 1.0 : 0.0) : (bit ? -1.0 : 1.0);
+            value = gain * std::sin(carrier_step * n + impairments.carrier_phase);
+        }
+        samples.append(value + (add_noise ? noise(engine) : 0.0));
+    }
+    return samples;
+}
+
+QByteArray ToText(const QList<double> &samples)
+{
+    // 每个采样最多约 24 字符，一次性分配后用 to_chars 写入
+    QByteArray text(samples.size() * 25, Qt::Uninitialized);
+    char *out = text.data();
+    char *const end = out + text.size();
+    for (const auto sample : samples) {
+        out = std::to_chars(out, end, sample, std::chars_format::fixed, 6).ptr;
+        *out++ = ' ';
+    }
+    text.truncate(out - text.data());
+    return text;
+}
+
+QByteArray ToContainer(const QList<double> &samples, SampleContainer::SampleType sample_type,
+                       const ModemParams &params)
+{
+    SampleContainer::Header header;
+    header.version = SampleContainer::kVersion;
+    header.sample_type = sample_type;
+    header.sample_rate = params.sample_rate;
+    header.samples_per_bit = static_cast<quint32>(params.samples_per_bit);
+    header.carrier_freq = params.carrier_freq;
+    header.sample_count = samples.size();
+    QByteArray data = SampleContainer::WriteHeader(header);
+    const auto header_size = data.size();
+    data.resize(header_size + samples.size() * SampleContainer::SampleSize(sample_type));
+    char *out = data.data() + header_size;
+    for (const auto sample : samples) {
+        switch (sample_type) {
+        case SampleContainer::kInt16: {
+            const auto value = static_cast<qint16>(qBound(-32768.0, std::round(sample * 32768.0), 32767.0));
+            qToLittleEndian(value, out);
+            out += 2;
+            break;
+        }
+        case SampleContainer::kFloat32: {
+            const float value = static_cast<float>(sample);
+            quint32 bits;
+            memcpy(&bits, &value, sizeof(bits));
+            qToLittleEndian(bits, out);
+            out += 4;
+            break;
+        }
+        case SampleContainer::kFloat64: {
+            quint64 bits;
+            memcpy(&bits, &sample, sizeof(bits));
+            qToLittleEndian(bits, out);
+            out += 8;
+            break;
+        }
+        }
+    }
+    return data;
+}
+
+qsizetype CountBitErrors(const QByteArray &payload, const QByteArray &decoded_bytes)
+{
+    const auto common = qMin(payload.size(), decoded_bytes.size());
+    qsizetype errors{ (payload.size() - common) * 8 };
+    for (qsizetype i{ 0 }; i < common; ++i) {
+        errors += qPopulationCount(static_cast<quint8>(payload[i] ^ decoded_bytes[i]));
+    }
+    return errors;
+}
+
+}
@@ -0,0 +1,41 @@
+﻿#pragma once
+
+#include <QtGlobal>
+#include <QByteArray>
+#include <QList>
+#include "samplecontainer.h"
+#include "modemparams.h"
+
+// 合成信号发生器：按给定调制参数生成 ASK/PSK 采样流，可叠加指定信噪比的高斯白噪声
+namespace SignalGenerator {
+
+enum class Scheme {
+    kAsk,
+    kPsk
+};
+
+// 模拟实际录音的信道偏差
+struct Impairments {
+    double clock_offset{ 0.0 };         // 发送端比特时钟相对标称值的偏差，正值表示比特更短
+    double carrier_offset_hz{ 0.0 };    // 载波频率偏移
+    double carrier_phase{ 0.0 };        // 载波初相（弧度）
+    double lead_in_samples{ 0.0 };      // 数据之前的纯噪声长度，可含小数
+};
+
+// 可打印 ASCII 文本负载，相同 seed 生成相同内容
+QByteArray MakePayload(qsizetype size, quint32 seed);
+// 负载按高位在前逐比特调制；snr_db 为相对载波功率的信噪比，传入无穷大表示不加噪声
+QList<double> Modulate(const QByteArray &payload, Scheme scheme, double snr_db, quint32 seed,
+                       const ModemParams &params = ModemParams());
+// 连续相位载波（不随比特边界重新开始），叠加时钟偏差、载波频偏与前置噪声，供同步解调测试
+QList<double> ModulateContinuous(const QByteArray &payload, Scheme scheme, double snr_db, quint32 seed,
+                                 const ModemParams &params, const Impairments &impairments);
+// 空白分隔的采样文本，与发送端的文本格式一致
+QByteArray ToText(const QList<double> &samples);
+// SampleContainer 二进制容器
+QByteArray ToContainer(const QList<double> &samples, SampleContainer::SampleType sample_type,
+                       const ModemParams &params = ModemParams());
+// 与解调结果逐比特比较，返回不一致的比特数
+qsizetype CountBitErrors(const QByteArray &payload, const QByteArray &decoded_bytes);
+
+}
@@ -0,0 +1,132 @@
+﻿#include "batchprocessor.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QElapsedTimer>
+
+namespace {
+
+QString FormatMs(qint64 us)
+{
+    return QString::number(us / 1000.0, 'f', 2) + " ms";
+}
+
+}
+
+BatchProcessor::BatchProcessor(QTextStream &out, QTextStream &err, QObject *parent)
+    : QObject(parent)
+    , out_(out)
+    , err_(err)
+    , txt_model_(new TxtModel(this))
+{
+}
+
+bool BatchProcessor::ProcessFile(const QString &file_path)
+{
+    StageTimes times;
+    QElapsedTimer timer;
+    ++file_count_;
+    // 加载
+    timer.start();
+    if (!txt_model_->set_modem_params(modem_params_) || !txt_model_->LoadTxtFile(file_path)) {
+        ++failed_count_;
+        err_ << file_path << ": " << txt_model_->get_error_message() << Qt::endl;
+        return false;
+    }
+    times.load_us = timer.nsecsElapsed() / 1000;
+    times.sample_count = txt_model_->get_txt_modulated_data().size();
+    // 解调：同步调用，内部仍按块并行
+    timer.restart();
+    txt_model_->DemodulateTxtFile(demodulate_t_);
+    times.demodulate_us = timer.nsecsElapsed() / 1000;
+    times.bit_count = txt_model_->get_txt_demodulated_data().size();
+    // 解码
+    timer.restart();
+    txt_model_->DecodeTxtFile(decode_t_);
+    times.decode_us = timer.nsecsElapsed() / 1000;
+    // 保存
+    timer.restart();
+    const auto output_path = OutputPath(file_path);
+    if (!txt_model_->SaveRecoverdFile(output_path)) {
+        ++failed_count_;
+        err_ << file_path << ": " << txt_model_->get_error_message() << Qt::endl;
+        return false;
+    }
+    times.save_us = timer.nsecsElapsed() / 1000;
+
+    total_times_.load_us += times.load_us;
+    total_times_.demodulate_us += times.demodulate_us;
+    total_times_.decode_us += times.decode_us;
+    total_times_.save_us += times.save_us;
+    total_times_.sample_count += times.sample_count;
+    total_times_.bit_count += times.bit_count;
+    out_ << file_path << " -> " << output_path
+         << "  采样 " << times.sample_count << "  比特 " << times.bit_count
+         << "  加载 " << FormatMs(times.load_us)
+         << "  解调 " << FormatMs(times.demodulate_us)
+         << "  解码 " << FormatMs(times.decode_us)
+         << "  保存 " << FormatMs(times.save_us) << Qt::endl;
+    return true;
+}
+
+int BatchProcessor::ProcessPaths(const QStringList &paths, bool recursive)
+{
+    const auto failed_before = failed_count_;
+    const auto files = CollectFiles(paths, recursive);
+    for (const auto &file_path : files) {
+        ProcessFile(file_path);
+    }
+    return failed_count_ - failed_before;
+}
+
+void BatchProcessor::PrintSummary() const
+{
+    const auto total_us = total_times_.load_us + total_times_.demodulate_us + total_times_.decode_us + total_times_.save_us;
+    out_ << "共处理 " << file_count_ << " 个文件，失败 " << failed_count_ << " 个" << Qt::endl
+         << "  加载 " << FormatMs(total_times_.load_us)
+         << "  解调 " << FormatMs(total_times_.demodulate_us)
+         << "  解码 " << FormatMs(total_times_.decode_us)
+         << "  保存 " << FormatMs(total_times_.save_us)
+         << "  合计 " << FormatMs(total_us) << Qt::endl;
+    if (total_times_.demodulate_us > 0) {
+        out_ << "  解调吞吐 " << QString::number(total_times_.sample_count / (total_times_.demodulate_us / 1e6) / 1e6, 'f', 2)
+             << " M采样/s" << Qt::endl;
+    }
+}
+
+QStringList BatchProcessor::CollectFiles(const QStringList &paths, bool recursive)
+{
+    // 目录中只取采样文件，按名称排序保证输出稳定
+    const QStringList name_filters{ "*.txt", "*.srb", "*.wav" };
+    QStringList files;
+    for (const auto &path : paths) {
+        const QFileInfo info(path);
+        if (!info.isDir()) {
+            files.append(path);
+            continue;
+        }
+        QStringList dir_files;
+        QDirIterator it(path, name_filters, QDir::Files,
+                        recursive ? QDirIterator::Subdirectories : QDirIterator::NoIteratorFlags);
+        while (it.hasNext()) {
+            const auto file_path = it.next();
+            // 跳过本工具输出的解码结果
+            if (!file_path.endsWith(".decoded.txt")) {
+                dir_files.append(file_path);
+            }
+        }
+        dir_files.sort();
+        files.append(dir_files);
+    }
+    return files;
+}
+
+QString BatchProcessor::OutputPath(const QString &file_path) const
+{
+    const QFileInfo info(file_path);
+    const auto file_name = info.completeBaseName() + ".decoded.txt";
+    if (output_directory_.isEmpty()) {
+        return info.dir().filePath(file_name);
+    }
+    return QDir(output_directory_).filePath(file_name);
+}
@@ -0,0 +1,59 @@
+﻿#pragma once
+
+#include <QObject>
+#include <QStringList>
+#include <QTextStream>
+#include "txtmodel.h"
+
+// 批量解调解码：逐个文件完成加载、解调、解码与保存，并统计各阶段耗时。
+// 不依赖任何界面组件，供命令行接收端使用
+class BatchProcessor : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 各阶段累计耗时（微秒）
+    struct StageTimes {
+        qint64 load_us{ 0 };
+        qint64 demodulate_us{ 0 };
+        qint64 decode_us{ 0 };
+        qint64 save_us{ 0 };
+        qint64 sample_count{ 0 };
+        qint64 bit_count{ 0 };
+    };
+
+    BatchProcessor(QTextStream &out, QTextStream &err, QObject *parent);
+
+    void set_demodulation(const QString &demodulate_t) { demodulate_t_ = demodulate_t; }
+    void set_decoding(const QString &decode_t) { decode_t_ = decode_t; }
+    // 文本采样文件的调制参数；二进制容器总是使用其文件头中的参数
+    void set_modem_params(const ModemParams &params) { modem_params_ = params; }
+    // 解码结果的保存目录，留空时保存在源文件旁
+    void set_output_directory(const QString &directory_path) { output_directory_ = directory_path; }
+
+    bool ProcessFile(const QString &file_path);
+    // 处理文件或目录列表，返回失败的文件数
+    int ProcessPaths(const QStringList &paths, bool recursive);
+    void PrintSummary() const;
+
+    int get_file_count() const { return file_count_; }
+    int get_failed_count() const { return failed_count_; }
+    const StageTimes &get_total_times() const { return total_times_; }
+
+    static QStringList CollectFiles(const QStringList &paths, bool recursive);
+
+private:
+    QString OutputPath(const QString &file_path) const;
+
+private:
+    QTextStream &out_;
+    QTextStream &err_;
+    TxtModel *txt_model_;
+    QString demodulate_t_{ "ASK" };
+    QString decode_t_{ "UTF-8" };
+    ModemParams modem_params_;
+    QString output_directory_;
+    int file_count_{ 0 };
+    int failed_count_{ 0 };
+    StageTimes total_times_;
+};
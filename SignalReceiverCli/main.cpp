@@ -0,0 +1,183 @@
+﻿#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include "batchprocessor.h"
+#include "networkmodel.h"
+#include "receiveserver.h"
+
+// 无界面的命令行接收端：
+//   批量处理   SignalReceiverCli [选项] <文件或目录>...
+//   客户端接收 SignalReceiverCli --connect <ip>:<port> [选项]
+//   服务器接收 SignalReceiverCli --listen <port> [--bind <ip>] [选项]
+// 接收模式下加上 --process 时，每个文件接收完成后立即解调解码
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("SignalReceiverCli");
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("SignalReceiver 命令行接收、解调与解码工具");
+    parser.addHelpOption();
+    const QCommandLineOption connect_option("connect", "连接到发送端并接收文件", "ip:port");
+    const QCommandLineOption listen_option("listen", "监听端口，接收多个发送端的文件", "port");
+    const QCommandLineOption bind_option("bind", "服务器模式下监听的地址，默认所有网卡", "ip");
+    const QCommandLineOption receive_dir_option("receive-dir", "接收文件的保存目录，默认当前目录", "dir");
+    const QCommandLineOption output_option({ "o", "output" }, "解码结果的保存目录，默认与源文件相同", "dir");
+    const QCommandLineOption demodulation_option({ "m", "demodulation" }, "解调方式: ASK 或 PSK", "scheme", "ASK");
+    const QCommandLineOption decoding_option({ "d", "decoding" }, "解码方式: UTF-8 或 UTF-16", "encoding", "UTF-8");
+    const QCommandLineOption process_option("process", "接收模式下每个文件接收完成后立即解调解码");
+    const QCommandLineOption count_option("count", "接收指定数量的文件后退出", "n");
+    const QCommandLineOption recursive_option({ "r", "recursive" }, "批量处理时递归子目录");
+    const QCommandLineOption workers_option("workers", "服务器模式的工作线程数，默认为 CPU 核数", "n");
+    const ModemParams default_params;
+    const QCommandLineOption sample_rate_option("sample-rate", "文本采样文件的采样率 (Hz)", "hz",
+                                                QString::number(default_params.sample_rate));
+    const QCommandLineOption samples_per_bit_option("samples-per-bit", "文本采样文件每比特的采样数", "n",
+                                                    QString::number(default_params.samples_per_bit));
+    const QCommandLineOption carrier_option("carrier", "文本采样文件的载波频率 (Hz)", "hz",
+                                            QString::number(default_params.carrier_freq));
+    const QCommandLineOption sync_option("sync", "同步解调：恢复载波与位定时，适用于有时钟偏差的采集数据");
+    const QCommandLineOption preamble_option("preamble", "同步解调的前导码（十六进制），找到后才开始输出比特", "hex");
+    parser.addOptions({ connect_option, listen_option, bind_option, receive_dir_option, output_option,
+                        demodulation_option, decoding_option, process_option, count_option,
+                        recursive_option, workers_option, sample_rate_option, samples_per_bit_option,
+                        carrier_option, sync_option, preamble_option });
+    parser.addPositionalArgument("paths", "批量处理的采样文件或目录", "[paths...]");
+    parser.process(app);
+
+    const auto demodulate_t = parser.value(demodulation_option).toUpper();
+    const auto decode_t = parser.value(decoding_option).toUpper();
+    if ((demodulate_t != "ASK" && demodulate_t != "PSK") || (decode_t != "UTF-8" && decode_t != "UTF-16")) {
+        err << "不支持的解调或解码方式" << Qt::endl;
+        return 2;
+    }
+    ModemParams modem_params;
+    modem_params.sample_rate = parser.value(sample_rate_option).toDouble();
+    modem_params.samples_per_bit = parser.value(samples_per_bit_option).toLongLong();
+    modem_params.carrier_freq = parser.value(carrier_option).toDouble();
+    modem_params.symbol_sync = parser.isSet(sync_option) || parser.isSet(preamble_option);
+    QString params_error;
+    if (!ModemParams::ParsePreamble(parser.value(preamble_option), modem_params.preamble, &params_error)
+        || !modem_params.Validate(&params_error)) {
+        err << params_error << Qt::endl;
+        return 2;
+    }
+    BatchProcessor processor(out, err, nullptr);
+    processor.set_demodulation(demodulate_t);
+    processor.set_decoding(decode_t);
+    processor.set_modem_params(modem_params);
+    if (parser.isSet(output_option)) {
+        const auto output_dir = parser.value(output_option);
+        QDir().mkpath(output_dir);
+        processor.set_output_directory(output_dir);
+    }
+
+    // 客户端与服务器接收模式互斥
+    if (parser.isSet(connect_option) && parser.isSet(listen_option)) {
+        err << "--connect 与 --listen 不能同时使用" << Qt::endl;
+        return 2;
+    }
+
+    // 批量模式
+    if (!parser.isSet(connect_option) && !parser.isSet(listen_option)) {
+        const auto paths = parser.positionalArguments();
+        if (paths.isEmpty()) {
+            parser.showHelp(2);
+        }
+        QElapsedTimer timer;
+        timer.start();
+        const int failed = processor.ProcessPaths(paths, parser.isSet(recursive_option));
+        processor.PrintSummary();
+        out << "总耗时 " << timer.elapsed() << " ms" << Qt::endl;
+        return failed == 0 ? 0 : 1;
+    }
+
+    // 接收模式
+    const auto receive_dir = parser.isSet(receive_dir_option) ? parser.value(receive_dir_option) : QDir::currentPath();
+    QDir().mkpath(receive_dir);
+    const int max_files = parser.value(count_option).toInt();
+    const bool process = parser.isSet(process_option);
+    int received_count{ 0 };
+    QElapsedTimer receive_timer;
+    receive_timer.start();
+    // 每收到一个文件计数，按需处理，达到数量后退出
+    const auto on_file_received = [&](const QString &saved_file_path) {
+        ++received_count;
+        out << "已接收 " << saved_file_path << "  (" << receive_timer.elapsed() << " ms)" << Qt::endl;
+        if (process) {
+            processor.ProcessFile(saved_file_path);
+        }
+        if (max_files > 0 && received_count >= max_files) {
+            app.quit();
+        }
+    };
+
+    NetworkModel network_model(nullptr);
+    ReceiveServer receive_server(nullptr);
+    if (parser.isSet(connect_option)) {
+        const auto target = parser.value(connect_option);
+        const auto separator = target.lastIndexOf(':');
+        if (separator <= 0) {
+            err << "连接目标应为 ip:port" << Qt::endl;
+            return 2;
+        }
+        network_model.set_receive_directory(receive_dir);
+        QObject::connect(&network_model, &NetworkModel::fileReceiveCompleted, &app, on_file_received);
+        QObject::connect(&network_model, &NetworkModel::fileReceiveError, &app, [&](const QString &error_message) {
+            err << "文件接收错误: " << error_message << Qt::endl;
+        });
+        QObject::connect(&network_model, &NetworkModel::connectionRetrying, &app,
+                         [&](int attempt, int max_retries, int delay_ms, const QString &reason) {
+            err << "连接失败: " << reason << "，" << delay_ms << " 毫秒后第 " << attempt << "/" << max_retries << " 次重试" << Qt::endl;
+        });
+        QObject::connect(&network_model, &NetworkModel::connectionChanged, &app, [&](NetworkModel::ConnectionState state) {
+            if (state == NetworkModel::Connected) {
+                out << "已连接 " << target << Qt::endl;
+            } else if (state == NetworkModel::Error) {
+                // 发送端关闭连接也以错误结束，已收到文件时视为正常退出
+                err << "连接结束: " << network_model.get_error_message() << Qt::endl;
+                app.exit(received_count > 0 ? 0 : 1);
+            }
+        });
+        network_model.StartConnection(target.left(separator), target.mid(separator + 1));
+    } else {
+        receive_server.set_receive_directory(receive_dir);
+        if (parser.isSet(workers_option)) {
+            receive_server.set_worker_count(parser.value(workers_option).toInt());
+        }
+        QObject::connect(&receive_server, &ReceiveServer::fileReceiveCompleted, &app,
+                         [&](const QString &, const QString &saved_file_path) { on_file_received(saved_file_path); });
+        QObject::connect(&receive_server, &ReceiveServer::fileReceiveError, &app,
+                         [&](const QString &peer, const QString &error_message) {
+            err << "[" << peer << "] 文件接收错误: " << error_message << Qt::endl;
+        });
+        QObject::connect(&receive_server, &ReceiveServer::connectionOpened, &app, [&](quint64 connection_id, const QString &peer) {
+            out << "发送端 #" << connection_id << " 已连接: " << peer << Qt::endl;
+        });
+        QObject::connect(&receive_server, &ReceiveServer::statsUpdated, &app,
+                         [&](int connection_count, qint64 total_bytes, double bytes_per_second) {
+            if (connection_count > 0) {
+                out << "连接数 " << connection_count << "  累计 " << total_bytes / (1024 * 1024) << " MB  吞吐 "
+                    << QString::number(bytes_per_second / (1024 * 1024), 'f', 2) << " MB/s" << Qt::endl;
+            }
+        });
+        if (!receive_server.Start(parser.value(bind_option), parser.value(listen_option))) {
+            err << "监听失败: " << receive_server.get_error_message() << Qt::endl;
+            return 1;
+        }
+        out << "正在监听端口 " << parser.value(listen_option) << Qt::endl;
+    }
+    const int exit_code = app.exec();
+    network_model.CloseConnection();
+    receive_server.Stop();
+    if (process) {
+        processor.PrintSummary();
+    }
+    out << "共接收 " << received_count << " 个文件，用时 " << receive_timer.elapsed() << " ms" << Qt::endl;
+    return exit_code;
+}